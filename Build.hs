@@ -5,11 +5,13 @@ import Development.Shake.Command
 import Development.Shake.FilePath
 import Development.Shake.Util
 
-src, test, srcout, testout :: FilePath
+src, test, bench, srcout, testout, benchout :: FilePath
 src = "src"
 test = "test"
+bench = "bench"
 srcout = "out"
 testout = "testout"
+benchout = "benchout"
 
 cflags, ldflags :: String
 #ifndef cxx
@@ -33,8 +35,23 @@ main = shakeArgs shakeOptions{shakeFiles=srcout{-, shakeThreads=0-}} $ do
   phony "clean" $
     removeFilesAfter srcout ["//*"] >>
     removeFilesAfter testout ["//*"] >>
+    removeFilesAfter benchout ["//*"] >>
     removeFilesAfter "." ["//~*", "//#*#"]
 
+  -- every file in bench is its own optimized program.
+  phony "bench" $ do
+    benches <- getDir bench
+    let exes = [benchout </> b -<.> exe | b <- benches]
+    need exes
+    mapM_ (\e -> cmd ("./" ++ e) :: Action ()) exes
+
+  "//" ++ benchout </> "*" <.> exe %> \out -> do
+    let c = bench </> takeFileName out -<.> "cc"
+    let m = out -<.> "m"
+    () <- cmd cxx [c] "-o" [out] cflags "-O2" "-MMD -MF" [m]
+              ("-I" ++ src) "-lpthread"
+    needMakefileDependencies m
+
   phony "doc" $ cmd "doxygen" ["Doxyfile"]
 
   phony "tags" $ getSourceAndHeaders >>= cmd "etags"
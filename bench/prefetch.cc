@@ -0,0 +1,135 @@
+// Random gathers with and without `prefetching`.  Run with
+// `./make bench`.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "iterator.hh"
+#include "prefetch.hh"
+
+using prelude::iterator;
+using prelude::prefetching;
+using prelude::PrefetchingIterator;
+using prelude::VectorIterator;
+namespace prefetch = prelude::prefetch;
+namespace view = prelude::view;
+
+// a cache line per cell, so every gather misses.
+struct Cell {
+    long value;
+    char padding[64 - sizeof(long)];
+};
+
+struct CellAt {
+    const Cell* table;
+    const Cell* operator()(size_t i) const { return table + i; }
+};
+
+// enough dependent work per element that out of order execution can't
+// keep many gathers in flight by itself.
+static long mix(long value) {
+    uint64_t x = static_cast<uint64_t>(value);
+    for (int round = 0; round < 8; ++round) {
+        x ^= x >> 29;
+        x *= 0xbf58476d1ce4e5b9ULL;
+    }
+    return static_cast<long>(x >> 16);
+}
+
+struct SumAt {
+    const Cell* table;
+    long* sum;
+    void operator()(size_t i) const { *sum += mix(table[i].value); }
+};
+
+struct SumPointee {
+    long* sum;
+    void operator()(const Cell* cell) const { *sum += mix(cell->value); }
+};
+
+static double now() {
+    timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void report(const char* name, double start, long sum) {
+    printf("%-40s %8.1f ms  (%ld)\n", name, (now() - start) * 1e3, sum);
+}
+
+int main() {
+    const size_t cells = 1 << 20;
+    const size_t gathers = 1 << 23;
+    const size_t distance = 16;
+
+    std::vector<Cell> table(cells);
+    for (size_t i = 0; i < cells; ++i) {
+        table[i].value = static_cast<long>(i);
+    }
+    std::vector<size_t> indices(gathers);
+    uint64_t state = 88172645463325252ULL;
+    for (size_t i = 0; i < gathers; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        indices[i] = state % cells;
+    }
+    std::vector<const Cell*> pointers(gathers);
+    for (size_t i = 0; i < gathers; ++i) {
+        pointers[i] = &table[indices[i]];
+    }
+
+    CellAt at = {&table[0]};
+    double start;
+    long sum;
+
+    sum = 0;
+    start = now();
+    SumAt sum_at = {&table[0], &sum};
+    std::for_each(indices.begin(), indices.end(), sum_at);
+    report("index gather", start, sum);
+
+    sum = 0;
+    start = now();
+    view::Range<prefetch::Adapter<std::vector<size_t>::const_iterator,
+                                  CellAt> >
+        prefetched = prefetching(indices, distance, at);
+    std::for_each(prefetched.begin(), prefetched.end(), sum_at);
+    report("index gather, prefetching", start, sum);
+
+    sum = 0;
+    start = now();
+    SumPointee sum_pointee = {&sum};
+    std::for_each(pointers.begin(), pointers.end(), sum_pointee);
+    report("pointer gather", start, sum);
+
+    sum = 0;
+    start = now();
+    view::Range<prefetch::Adapter<std::vector<const Cell*>::const_iterator,
+                                  prefetch::pointee> >
+        prefetched_pointers =
+            prefetching(pointers, distance, prefetch::pointee());
+    std::for_each(prefetched_pointers.begin(), prefetched_pointers.end(),
+                  sum_pointee);
+    report("pointer gather, prefetching", start, sum);
+
+    sum = 0;
+    start = now();
+    VectorIterator<size_t> it = iterator(indices);
+    for (size_t* i = it.get(); i; i = (++it).get()) {
+        sum += mix(table[*i].value);
+    }
+    report("Iterator<size_t> gather", start, sum);
+
+    sum = 0;
+    start = now();
+    VectorIterator<size_t> source = iterator(indices);
+    PrefetchingIterator<size_t, CellAt> pit =
+        prefetching(source, distance, at);
+    for (size_t* i = pit.get(); i; i = (++pit).get()) {
+        sum += mix(table[*i].value);
+    }
+    report("Iterator<size_t> gather, prefetching", start, sum);
+}
@@ -0,0 +1,282 @@
+#ifndef HEADER_GUARD_ADAPTIVE_PREDICATE_H
+#define HEADER_GUARD_ADAPTIVE_PREDICATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#if __cplusplus >= 201103L
+#include <chrono>
+#endif
+#include "predicate.hh"
+
+namespace prelude {
+/// Opt in reordering of `and` and `or` chains.  `reorder(a and b and
+/// c)` splits the chain into its clauses and evaluates them with short
+/// circuiting in an order it keeps adjusting: every so often a call
+/// evaluates every clause and records whether each passed and how long
+/// it took, and every so often the clauses are sorted by the expected
+/// cost of reaching the answer.  For `and` that puts cheap clauses
+/// that usually fail first, for `or` cheap clauses that usually pass.
+///
+/// Results don't change as long as the clauses have no side effects.
+/// Copies share their clauses and statistics, so the statistics of a
+/// predicate passed by value to an algorithm can be read afterwards.
+/// Neither the sharing nor the statistics are thread safe: use a
+/// predicate in one scan at a time.
+namespace adaptive {
+
+/// a timestamp in arbitrary units, only ever compared between clauses.
+inline uint64_t ticks() {
+#if (defined(__GNUC__) or defined(__clang__)) and \
+    (defined(__x86_64__) or defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#elif __cplusplus >= 201103L
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#else
+    // without a clock every clause costs the same.
+    return 0;
+#endif
+}
+
+template <class T>
+struct Clause {
+    virtual bool operator()(T x) const = 0;
+    virtual ~Clause() {}
+};
+
+template <class T, class Pred>
+struct Leaf : public Clause<T> {
+    bool operator()(T x) const { return pred(x); }
+
+    explicit Leaf(const Pred& pred)
+        : pred(pred) {}
+
+    Pred pred;
+};
+
+/// what is known about one clause.  Pass rates and costs only come
+/// from the sampled calls, which evaluate every clause, so they aren't
+/// skewed by the clauses before it.
+struct ClauseStatistics {
+    /// calls that evaluated this clause, sampled or not.
+    size_t calls;
+    size_t samples;
+    size_t sample_passes;
+    uint64_t sample_ticks;
+
+    ClauseStatistics()
+        : calls(0)
+        , samples(0)
+        , sample_passes(0)
+        , sample_ticks(0) {}
+
+    double pass_rate() const {
+        return samples ? double(sample_passes) / samples : 0.5;
+    }
+    double cost() const {
+        return samples ? double(sample_ticks) / samples : 0;
+    }
+};
+
+/// splits `pred` into the clauses of a chain of `Op`.
+template <class T, class Pred, class Op>
+struct flattener {
+    static void add(const Pred& pred, std::vector<Clause<T>*>& clauses) {
+        clauses.push_back(new Leaf<T, Pred>(pred));
+    }
+};
+
+template <class T, class Pred1, class Pred2, class Op>
+struct flattener<T, CombinatoryPredicate<T, Pred1, Pred2, Op>, Op> {
+    static void add(const CombinatoryPredicate<T, Pred1, Pred2, Op>& pred,
+                    std::vector<Clause<T>*>& clauses) {
+        flattener<T, Pred1, Op>::add(pred.left(), clauses);
+        flattener<T, Pred2, Op>::add(pred.right(), clauses);
+    }
+};
+
+template <class T>
+class Predicate : public UnaryPredicate<T> {
+    struct State {
+        size_t references;
+        // a chain of `or`s stops at the first pass, of `and`s at the
+        // first failure.
+        bool disjunction;
+        std::vector<Clause<T>*> clauses;
+        std::vector<ClauseStatistics> statistics;
+        std::vector<size_t> order;
+        size_t sample_period;
+        size_t reorder_period;
+        size_t calls;
+    };
+
+    // lower is evaluated earlier: the expected cost of a clause divided
+    // by the chance it ends the chain.
+    struct ByRank {
+        const State* state;
+
+        double rank(size_t i) const {
+            const ClauseStatistics& stats = state->statistics[i];
+            double stops = state->disjunction ? stats.pass_rate()
+                                              : 1 - stats.pass_rate();
+            // the 1 keeps free clauses ordered by how often they stop.
+            return (stats.cost() + 1) / (stops > 0 ? stops : 1e-9);
+        }
+
+        bool operator()(size_t a, size_t b) const {
+            return rank(a) < rank(b);
+        }
+    };
+
+    State* state;
+
+    bool sample(T x) const {
+        bool result = not state->disjunction;
+        for (size_t i = 0; i < state->clauses.size(); ++i) {
+            ClauseStatistics& stats = state->statistics[i];
+            uint64_t start = ticks();
+            bool passed = (*state->clauses[i])(x);
+            stats.sample_ticks += ticks() - start;
+            ++stats.calls;
+            ++stats.samples;
+            stats.sample_passes += passed;
+            result = state->disjunction ? result or passed
+                                        : result and passed;
+        }
+        return result;
+    }
+
+    bool evaluate(T x) const {
+        for (size_t i = 0; i < state->order.size(); ++i) {
+            size_t clause = state->order[i];
+            ++state->statistics[clause].calls;
+            if ((*state->clauses[clause])(x) == state->disjunction) {
+                return state->disjunction;
+            }
+        }
+        return not state->disjunction;
+    }
+
+    void release() {
+        if (--state->references == 0) {
+            for (size_t i = 0; i < state->clauses.size(); ++i) {
+                delete state->clauses[i];
+            }
+            delete state;
+        }
+    }
+
+public:
+    /// takes ownership of `clauses`, which are numbered in the order
+    /// given from then on.
+    Predicate(const std::vector<Clause<T>*>& clauses, bool disjunction,
+              size_t sample_period, size_t reorder_period)
+        : state(new State()) {
+        state->references = 1;
+        state->disjunction = disjunction;
+        state->clauses = clauses;
+        state->statistics.resize(clauses.size());
+        for (size_t i = 0; i < clauses.size(); ++i) {
+            state->order.push_back(i);
+        }
+        state->sample_period = sample_period ? sample_period : 1;
+        state->reorder_period = reorder_period;
+        state->calls = 0;
+    }
+
+    Predicate(const Predicate& other)
+        : UnaryPredicate<T>(other)
+        , state(other.state) {
+        ++state->references;
+    }
+
+    Predicate& operator=(const Predicate& other) {
+        ++other.state->references;
+        release();
+        state = other.state;
+        return *this;
+    }
+
+    ~Predicate() { release(); }
+
+    bool operator()(T x) const {
+        size_t call = state->calls++;
+        if (state->reorder_period and call != 0 and
+            call % state->reorder_period == 0) {
+            reorder();
+        }
+        if (call % state->sample_period == 0) {
+            return sample(x);
+        }
+        return evaluate(x);
+    }
+
+    /// sorts the clauses by what has been sampled so far.  Ties keep
+    /// their current order.
+    void reorder() const {
+        ByRank by_rank = {state};
+        std::stable_sort(state->order.begin(), state->order.end(),
+                         by_rank);
+    }
+
+    bool is_disjunction() const { return state->disjunction; }
+    size_t calls() const { return state->calls; }
+    /// indexed by the clauses' positions in the original chain.
+    const std::vector<ClauseStatistics>& statistics() const {
+        return state->statistics;
+    }
+    /// the positions in the original chain, in evaluation order.
+    const std::vector<size_t>& order() const { return state->order; }
+};
+
+const size_t default_sample_period = 64;
+const size_t default_reorder_period = 4096;
+
+/// `pred` as a single clause, which leaves nothing to reorder.
+template <class Pred>
+Predicate<typename Pred::argument_type> reorder(
+    const Pred& pred, size_t sample_period = default_sample_period,
+    size_t reorder_period = default_reorder_period) {
+    typedef typename Pred::argument_type T;
+    std::vector<Clause<T>*> clauses;
+    clauses.push_back(new Leaf<T, Pred>(pred));
+    return Predicate<T>(clauses, false, sample_period, reorder_period);
+}
+
+/// the clauses of `pred`, a chain of `and`s.  Nested `or`s stay single
+/// clauses.
+template <class T, class Pred1, class Pred2>
+Predicate<T> reorder(
+    const CombinatoryPredicate<T, Pred1, Pred2, std::logical_and<bool> >&
+        pred,
+    size_t sample_period = default_sample_period,
+    size_t reorder_period = default_reorder_period) {
+    std::vector<Clause<T>*> clauses;
+    flattener<T, CombinatoryPredicate<T, Pred1, Pred2,
+                                      std::logical_and<bool> >,
+              std::logical_and<bool> >::add(pred, clauses);
+    return Predicate<T>(clauses, false, sample_period, reorder_period);
+}
+
+/// the clauses of `pred`, a chain of `or`s.
+template <class T, class Pred1, class Pred2>
+Predicate<T> reorder(
+    const CombinatoryPredicate<T, Pred1, Pred2, std::logical_or<bool> >&
+        pred,
+    size_t sample_period = default_sample_period,
+    size_t reorder_period = default_reorder_period) {
+    std::vector<Clause<T>*> clauses;
+    flattener<T, CombinatoryPredicate<T, Pred1, Pred2,
+                                      std::logical_or<bool> >,
+              std::logical_or<bool> >::add(pred, clauses);
+    return Predicate<T>(clauses, true, sample_period, reorder_period);
+}
+
+}
+}
+
+#endif
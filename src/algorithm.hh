@@ -2,12 +2,23 @@
 #define HEADER_GUARD_ALGORITHM_H
 
 #include <assert.h>
+#include <string.h>
 #include <algorithm>
 #include <iterator>
+#include "batch_search.hh"
+#include "compiled_predicate.hh"
+#include "gallop.hh"
 #include "iterator.hh"
 #include <memory>
 #include "metaprogramming.hh"
+#include "parallel.hh"
+#include "prefetch.hh"
+#include "radix_sort.hh"
+#include "simd.hh"
+#include "sorted_index.hh"
 #include "type_traits.hh"
+#include "view.hh"
+#include "zip.hh"
 
 namespace prelude {
 
@@ -51,6 +62,65 @@ const T& move(const typename remove_const<
 }
 #endif
 
+/// how many elements `[first, last)` has when that takes no pass over
+/// it, otherwise 0.
+template <class Iterator>
+size_t size_hint(Iterator first, Iterator last,
+                 std::random_access_iterator_tag) {
+    return last - first;
+}
+
+template <class Iterator, class Category>
+size_t size_hint(Iterator, Iterator, Category) {
+    return 0;
+}
+
+template <class Iterator>
+size_t size_hint(Iterator first, Iterator last) {
+    return size_hint(
+        first, last,
+        typename std::iterator_traits<Iterator>::iterator_category());
+}
+
+// The algorithms that return a new container reserve its exact size,
+// or a bound on it, before filling it.  Define PRELUDE_SHRINK_RESULTS
+// to have them give back what a bound overshot.
+template <class Container>
+void reserve_result(Container& result, size_t n, true_type) {
+    result.reserve(n);
+}
+
+template <class Container>
+void reserve_result(Container&, size_t, false_type) {}
+
+template <class Container>
+void reserve_result(Container& result, size_t n) {
+    reserve_result(result, n, has_reserve<Container>());
+}
+
+template <class Container>
+void shrink_result(Container& result, true_type) {
+    if (result.capacity() != result.size()) {
+#if __cplusplus >= 201103L
+        result.shrink_to_fit();
+#else
+        Container(result).swap(result);
+#endif
+    }
+}
+
+template <class Container>
+void shrink_result(Container&, false_type) {}
+
+template <class Container>
+void shrink_result(Container& result) {
+#ifdef PRELUDE_SHRINK_RESULTS
+    shrink_result(result, has_reserve<Container>());
+#else
+    (void)result;
+#endif
+}
+
 // <algorithm>'s algorithms are differing based on release date
 // also allows for move semantics and std::begin.
 #if __cplusplus >= 201103L
@@ -102,19 +172,19 @@ bool none_of(InputIterator first, InputIterator last,
 template <class Container, class UnaryPredicate>
 bool all_of(const Container& container,
             UnaryPredicate IF_CPLUSPLUS_11(&&, ) pred) {
-    return all_of(begin(container), end(container), pred);
+    return compiled::all_of(begin(container), end(container), pred);
 }
 
 template <class Container, class UnaryPredicate>
 bool any_of(const Container& container,
             UnaryPredicate IF_CPLUSPLUS_11(&&, ) pred) {
-    return any_of(begin(container), end(container), pred);
+    return compiled::any_of(begin(container), end(container), pred);
 }
 
 template <class Container, class UnaryPredicate>
 bool none_of(const Container& container,
              UnaryPredicate IF_CPLUSPLUS_11(&&, ) pred) {
-    return none_of(begin(container), end(container), pred);
+    return compiled::none_of(begin(container), end(container), pred);
 }
 
 using ::std::for_each;
@@ -124,17 +194,23 @@ UnaryFunction for_each(Container& container, UnaryFunction fn) {
     return for_each(begin(container), end(container), fn);
 }
 
+/// `for_each` over a prelude `Iterator`, run on every core.  `fn` is
+/// called concurrently and in no particular order.
+template <class T, class UnaryFunction>
+void for_each_parallel(Iterator<T>& it, UnaryFunction fn) {
+    return parallel::for_each(it, fn);
+}
+
 using ::std::find;
 
 template <class Container, class T>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
 find(const Container& container, const T& val)
 #if __cplusplus >= 201103L
-    -> decltype(find(begin(container), end(container),
-                     forward<T>(val)))
+    -> decltype(find(begin(container), end(container), val))
 #endif
 {
-    return find(begin(container), end(container), val);
+    return simd::find(begin(container), end(container), val);
 }
 
 // template <class Container, class T>
@@ -148,13 +224,13 @@ find(const Container& container, const T& val)
 using ::std::find_if;
 
 template <class Container, class UnaryPredicate>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
 find_if(const Container& container, UnaryPredicate pred)
 #if __cplusplus >= 201103L
     -> decltype(find_if(begin(container), end(container), pred))
 #endif
 {
-    return find_if(begin(container), end(container), pred);
+    return compiled::find_if(begin(container), end(container), pred);
 }
 
 #if __cplusplus >= 201103L
@@ -249,7 +325,7 @@ find_first_of(const Container1& container1,
 using ::std::adjacent_find;
 
 template <class Container>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
 adjacent_find(const Container& container)
 #if __cplusplus >= 201103L
     -> decltype(std::adjacent_find(begin(container), end(container)))
@@ -259,7 +335,7 @@ adjacent_find(const Container& container)
 }
 
 template <class Container, class BinaryPredicate>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
 adjacent_find(const Container& container, BinaryPredicate pred)
 #if __cplusplus >= 201103L
     -> decltype(std::adjacent_find(begin(container), end(container),
@@ -272,27 +348,34 @@ adjacent_find(const Container& container, BinaryPredicate pred)
 using ::std::count;
 
 template <class Container, class T>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename std::iterator_traits<typename iterator_type_of<
+                          Container>::type>::difference_type)
 count(const Container& container, const T& val)
 #if __cplusplus >= 201103L
-    -> decltype(std::count(begin(container), end(container),
-                           forward<T>(val)))
+    -> decltype(std::count(begin(container), end(container), val))
 #endif
 {
-    return std::count(begin(container), end(container),
-                      forward<T>(val));
+    return simd::count(begin(container), end(container), val);
 }
 
 using ::std::count_if;
 
 template <class Container, class UnaryPredicate>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename std::iterator_traits<typename iterator_type_of<
+                          Container>::type>::difference_type)
 count_if(const Container& container, UnaryPredicate pred)
 #if __cplusplus >= 201103L
     -> decltype(std::count_if(begin(container), end(container), pred))
 #endif
 {
-    return std::count_if(begin(container), end(container), pred);
+    return compiled::count_if(begin(container), end(container), pred);
+}
+
+/// `count_if` over a prelude `Iterator`, run on every core.  `pred`
+/// is called concurrently, so it can't be an `adaptive::Predicate`.
+template <class T, class UnaryPredicate>
+size_t count_if_parallel(Iterator<T>& it, UnaryPredicate pred) {
+    return parallel::count_if(it, pred);
 }
 
 using ::std::mismatch;
@@ -508,12 +591,7 @@ BidirectionalOutputIterator copy_backward(
 }
 
 #if __cplusplus >= 201103L
-template <class InputIterator, class OutputIterator>
-OutputIterator move(InputIterator first, InputIterator last,
-                    OutputIterator output) {
-    return std::move(first, last, output);
-}
-
+// the iterator version comes with `using ::std::move` above.
 template <class Container, class OutputIterator>
 OutputIterator move(Container&& container, OutputIterator output) {
     return std::move(begin(container), end(container), output);
@@ -559,20 +637,21 @@ swap_ranges(Container1& container1, Container2& container2)
 
 using ::std::transform;
 
-template <class Container, class OutputIterator, class UnaryFunction>
-OutputIterator transform(const Container& container,
-                         UnaryFunction fn) {
+template <class Container, class UnaryFunction>
+Container transform(const Container& container, UnaryFunction fn) {
     Container result;
+    reserve_result(result, container.size());
     std::transform(begin(container), end(container),
                    std::back_inserter(result), fn);
     return result;
 }
 
-template <class Container, class OutputIterator, class BinaryFunction>
+template <class Container, class BinaryFunction>
 Container transform_binary(const Container& container1,
                            const Container& container2,
                            BinaryFunction fn) {
     Container result;
+    reserve_result(result, container1.size());
     std::transform(begin(container1), end(container1),
                    begin(container2), std::back_inserter(result), fn);
     return result;
@@ -674,7 +753,7 @@ using ::std::remove_if;
 template <class Container, class UnaryPredicate>
 void remove_if(Container& container, UnaryPredicate pred) {
     IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
-    it = std::remove_if(begin(container), end(container), pred);
+    it = compiled::remove_if(begin(container), end(container), pred);
     if (it != end(container)) {
         container.erase(it, end(container));
     }
@@ -686,13 +765,15 @@ template <class Container, class OutputIterator, class T>
 OutputIterator remove_copy(const Container& container,
                            OutputIterator output, const T& val) {
     return std::remove_copy(begin(container), end(container), output,
-                            forward<T>(val));
+                            val);
 }
 
 template <class Container, class T>
 Container remove_copy(const Container& container, const T& val) {
     Container result;
+    reserve_result(result, container.size());
     remove_copy(container, std::back_inserter(result), val);
+    shrink_result(result);
     return result;
 }
 
@@ -710,7 +791,9 @@ template <class Container, class UnaryPredicate>
 Container remove_copy_if(const Container& container,
                          UnaryPredicate pred) {
     Container result;
+    reserve_result(result, container.size());
     remove_copy_if(container, std::back_inserter(result), pred);
+    shrink_result(result);
     return result;
 }
 
@@ -745,8 +828,10 @@ void unique_with(ForwardIterator first, ForwardIterator last, BinaryPredicate pr
 template <class Container>
 Container unique_copy(const Container& container) {
     Container result;
+    reserve_result(result, container.size());
     std::unique_copy(begin(container), end(container),
                      std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
@@ -754,8 +839,10 @@ template <class Container, class BinaryPredicate>
 Container unique_copy_with(const Container& container,
                            BinaryPredicate pred) {
     Container result;
-    return std::unique_copy(begin(container), end(container),
-                            std::back_inserter(result), pred);
+    reserve_result(result, container.size());
+    std::unique_copy(begin(container), end(container),
+                     std::back_inserter(result), pred);
+    shrink_result(result);
     return result;
 }
 
@@ -763,7 +850,9 @@ template <class Container>
 Container unique_copy(typename iterator_type_of<Container>::type first,
                       typename iterator_type_of<Container>::type last) {
     Container result;
+    reserve_result(result, size_hint(first, last));
     std::unique_copy(first, last, std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
@@ -772,8 +861,9 @@ Container unique_copy_with(typename iterator_type_of<Container>::type first,
                            typename iterator_type_of<Container>::type last,
                            BinaryPredicate pred) {
     Container result;
-    return std::unique_copy(first, last, std::back_inserter(result),
-                            pred);
+    reserve_result(result, size_hint(first, last));
+    std::unique_copy(first, last, std::back_inserter(result), pred);
+    shrink_result(result);
     return result;
 }
 
@@ -824,11 +914,12 @@ OutputIterator reverse_copy(Container& container,
                              output);
 }
 
-template <class Container, class OutputIterator>
+template <class Container>
 Container reverse_copy(const Container& container) {
     Container result;
-    return std::reverse_copy(begin(container), end(container),
-                             std::back_inserter(result));
+    reserve_result(result, container.size());
+    std::reverse_copy(begin(container), end(container),
+                      std::back_inserter(result));
     return result;
 }
 
@@ -863,6 +954,7 @@ Container rotate_copy(
     typename iterator_type_of<Container>::type middle,
     typename iterator_type_of<Container>::type last) {
     Container result;
+    reserve_result(result, size_hint(first, last));
     std::rotate_copy(first, middle, last, std::back_inserter(result));
     return result;
 }
@@ -871,6 +963,7 @@ template <class Container, class ForwardIterator>
 Container rotate_copy(const Container& container,
                       ForwardIterator middle) {
     Container result;
+    reserve_result(result, container.size());
     std::rotate_copy(begin(container), middle, end(container),
                      std::back_inserter(result));
     return result;
@@ -963,7 +1056,7 @@ IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
                                pred))
     #endif
 {
-    return std::partition(begin(container), end(container), pred);
+    return compiled::partition(begin(container), end(container), pred);
 }
 
 using ::std::stable_partition;
@@ -1016,15 +1109,20 @@ std::pair<OutputIterator1, OutputIterator2> partition_copy(
 template <class Container, class UnaryPredicate>
 std::pair<Container, Container> partition_copy(
     const Container& container, UnaryPredicate pred) {
-    Container res1, res2;
+    std::pair<Container, Container> res;
+    // either side could get every element.
+    reserve_result(res.first, container.size());
+    reserve_result(res.second, container.size());
     partition_copy(begin(container), end(container),
-                   std::back_inserter(res1), std::back_inserter(res2),
-                   pred);
-    return std::pair<Container, Container>(move(res1), move(res2));
+                   std::back_inserter(res.first),
+                   std::back_inserter(res.second), pred);
+    shrink_result(res.first);
+    shrink_result(res.second);
+    return res;
 }
 
 template <class Container, class UnaryPredicate>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
 partition_point(const Container& container, UnaryPredicate pred)
 #if __cplusplus >= 201103L
     -> decltype(partition_point(begin(container), end(container),
@@ -1036,7 +1134,7 @@ partition_point(const Container& container, UnaryPredicate pred)
 
 template <class Container>
 void sort(Container& container) {
-    return std::sort(begin(container), end(container));
+    return radix::sort(begin(container), end(container));
 }
 
 template <class Container, class Compare>
@@ -1046,7 +1144,7 @@ void sort_with(Container& container, Compare comp) {
 
 template <class RandomAccessIterator>
 void sort(RandomAccessIterator first, RandomAccessIterator last) {
-    return std::sort(first, last);
+    return radix::sort(first, last);
 }
 
 template <class RandomAccessIterator, class Compare>
@@ -1055,6 +1153,34 @@ void sort_with(RandomAccessIterator first, RandomAccessIterator last,
     return std::sort(first, last, comp);
 }
 
+template <class Container>
+void sort_parallel(Container& container) {
+    return parallel::sort(
+        begin(container), end(container),
+        std::less<typename std::iterator_traits<typename iterator_type_of<
+            Container>::type>::value_type>());
+}
+
+template <class Container, class Compare>
+void sort_parallel_with(Container& container, Compare comp) {
+    return parallel::sort(begin(container), end(container), comp);
+}
+
+template <class RandomAccessIterator>
+void sort_parallel(RandomAccessIterator first,
+                   RandomAccessIterator last) {
+    return parallel::sort(
+        first, last,
+        std::less<typename std::iterator_traits<
+            RandomAccessIterator>::value_type>());
+}
+
+template <class RandomAccessIterator, class Compare>
+void sort_parallel_with(RandomAccessIterator first,
+                        RandomAccessIterator last, Compare comp) {
+    return parallel::sort(first, last, comp);
+}
+
 template <class Container>
 void stable_sort(Container& container) {
     return std::stable_sort(begin(container), end(container));
@@ -1105,24 +1231,20 @@ void partial_sort_with(RandomAccessIterator first,
     return std::partial_sort(first, middle, last, comp);
 }
 
-template <class Container, class RandomAccessIterator>
+template <class Container>
 Container partial_sort_copy(const Container& container, size_t n) {
-    Container result;
-    result.reserve(n);
+    Container result(std::min(n, container.size()));
     std::partial_sort_copy(begin(container), end(container),
-                           begin(result),
-                           next(begin(result), n));
+                           result.begin(), result.end());
     return result;
 }
 
 template <class Container, class Compare>
 Container partial_sort_copy_with(const Container& container, size_t n,
                                  Compare comp) {
-    Container result;
-    result.reserve(n);
+    Container result(std::min(n, container.size()));
     std::partial_sort_copy(begin(container), end(container),
-                           begin(result), next(begin(result), n),
-                           comp);
+                           result.begin(), result.end(), comp);
     return result;
 }
 
@@ -1144,10 +1266,7 @@ RandomAccessIterator partial_sort_copy_with(
 }
 
 #if __cplusplus >= 201103L
-template <class Iterator>
-bool is_sorted(Iterator first, Iterator last) {
-    return ::std::is_sorted(first, last);
-}
+using ::std::is_sorted;
 
 template <class Iterator, class Compare>
 bool is_sorted_with(Iterator first, Iterator last, Compare comp) {
@@ -1188,14 +1307,11 @@ bool is_sorted(const Container& container) {
 
 template <class Container, class Compare>
 bool is_sorted_with(const Container& container, Compare comp) {
-    return is_sorted(begin(container), end(container), comp);
+    return is_sorted_with(begin(container), end(container), comp);
 }
 
 #if __cplusplus >= 201103L
-template <class Iterator>
-Iterator is_sorted_until(Iterator first, Iterator last) {
-    return ::std::is_sorted_until(first, last);
-}
+using ::std::is_sorted_until;
 
 template <class Iterator, class Compare>
 Iterator is_sorted_until_with(Iterator first, Iterator last,
@@ -1236,7 +1352,7 @@ Iterator is_sorted_until_with(Iterator first, Iterator last,
 #endif
 
 template <class Container>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
     is_sorted_until(const Container& container)
     #if __cplusplus >= 201103L
     -> decltype(std::is_sorted_until(begin(container),
@@ -1247,7 +1363,7 @@ IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
 }
 
 template <class Container, class Compare>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
     is_sorted_until_with(const Container& container, Compare comp)
     #if __cplusplus >= 201103L
     -> decltype(std::is_sorted_until(begin(container), end(container),
@@ -1270,12 +1386,12 @@ void nth_element_with(Container& container, Iterator nth,
                             comp);
 }
 
-template <class Container, class Iterator>
+template <class Iterator>
 void nth_element(Iterator first, Iterator nth, Iterator last) {
     return std::nth_element(first, nth, last);
 }
 
-template <class Container, class Iterator, class Compare>
+template <class Iterator, class Compare>
 void nth_element_with(Iterator first, Iterator nth, Iterator last,
                       Compare comp) {
     return std::nth_element(first, nth, last, comp);
@@ -1414,6 +1530,98 @@ bool binary_search_with(Iterator first, Iterator last, const T& val,
     return std::binary_search(first, last, val, comp);
 }
 
+/// writes `lower_bound(first, last, key)` to `output` for every key in
+/// `[keys_first, keys_last)`.  Ascending keys are answered by
+/// galloping on from the previous answer; others are searched sixteen
+/// at a time so that their memory accesses overlap.
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator>
+OutputIterator lower_bound_batch(RandomAccessIterator first,
+                                 RandomAccessIterator last,
+                                 ForwardIterator keys_first,
+                                 ForwardIterator keys_last,
+                                 OutputIterator output) {
+    return batch::search<false>(first, last, keys_first, keys_last,
+                                output, batch::less());
+}
+
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator, class Compare>
+OutputIterator lower_bound_batch_with(RandomAccessIterator first,
+                                      RandomAccessIterator last,
+                                      ForwardIterator keys_first,
+                                      ForwardIterator keys_last,
+                                      OutputIterator output,
+                                      Compare comp) {
+    return batch::search<false>(first, last, keys_first, keys_last,
+                                output, comp);
+}
+
+template <class Container, class ForwardIterator, class OutputIterator>
+OutputIterator lower_bound_batch(Container& container,
+                                 ForwardIterator keys_first,
+                                 ForwardIterator keys_last,
+                                 OutputIterator output) {
+    return batch::search<false>(begin(container), end(container),
+                                keys_first, keys_last, output,
+                                batch::less());
+}
+
+template <class Container, class ForwardIterator, class OutputIterator,
+          class Compare>
+OutputIterator lower_bound_batch_with(Container& container,
+                                      ForwardIterator keys_first,
+                                      ForwardIterator keys_last,
+                                      OutputIterator output,
+                                      Compare comp) {
+    return batch::search<false>(begin(container), end(container),
+                                keys_first, keys_last, output, comp);
+}
+
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator>
+OutputIterator upper_bound_batch(RandomAccessIterator first,
+                                 RandomAccessIterator last,
+                                 ForwardIterator keys_first,
+                                 ForwardIterator keys_last,
+                                 OutputIterator output) {
+    return batch::search<true>(first, last, keys_first, keys_last,
+                               output, batch::less());
+}
+
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator, class Compare>
+OutputIterator upper_bound_batch_with(RandomAccessIterator first,
+                                      RandomAccessIterator last,
+                                      ForwardIterator keys_first,
+                                      ForwardIterator keys_last,
+                                      OutputIterator output,
+                                      Compare comp) {
+    return batch::search<true>(first, last, keys_first, keys_last,
+                               output, comp);
+}
+
+template <class Container, class ForwardIterator, class OutputIterator>
+OutputIterator upper_bound_batch(Container& container,
+                                 ForwardIterator keys_first,
+                                 ForwardIterator keys_last,
+                                 OutputIterator output) {
+    return batch::search<true>(begin(container), end(container),
+                               keys_first, keys_last, output,
+                               batch::less());
+}
+
+template <class Container, class ForwardIterator, class OutputIterator,
+          class Compare>
+OutputIterator upper_bound_batch_with(Container& container,
+                                      ForwardIterator keys_first,
+                                      ForwardIterator keys_last,
+                                      OutputIterator output,
+                                      Compare comp) {
+    return batch::search<true>(begin(container), end(container),
+                               keys_first, keys_last, output, comp);
+}
+
 template <class Container1, class Container2, class OutputIterator>
 OutputIterator merge(const Container1& container1, const Container2& container2,
                      OutputIterator output) {
@@ -1435,6 +1643,7 @@ template <class Container>
 Container merge(const Container& container1,
                 const Container& container2) {
     Container result;
+    reserve_result(result, container1.size() + container2.size());
     std::merge(begin(container1), end(container1), begin(container2),
                end(container2), std::back_inserter(result));
     return result;
@@ -1444,6 +1653,7 @@ template <class Container, class Compare>
 Container merge_with(const Container& container1,
                      const Container& container2, Compare comp) {
     Container result;
+    reserve_result(result, container1.size() + container2.size());
     std::merge(begin(container1), end(container1), begin(container2),
                end(container2), std::back_inserter(result), comp);
     return result;
@@ -1479,6 +1689,66 @@ void inplace_merge_with(Container& container,
                               end(container), comp);
 }
 
+/// stable `merge` spread over the available cores.  `output` must be
+/// random access.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class RandomAccessIterator3>
+RandomAccessIterator3 merge_parallel(RandomAccessIterator1 first1,
+                                     RandomAccessIterator1 last1,
+                                     RandomAccessIterator2 first2,
+                                     RandomAccessIterator2 last2,
+                                     RandomAccessIterator3 output) {
+    return parallel::merge(first1, last1, first2, last2, output,
+                           batch::less());
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class RandomAccessIterator3, class Compare>
+RandomAccessIterator3 merge_parallel_with(RandomAccessIterator1 first1,
+                                          RandomAccessIterator1 last1,
+                                          RandomAccessIterator2 first2,
+                                          RandomAccessIterator2 last2,
+                                          RandomAccessIterator3 output,
+                                          Compare comp) {
+    return parallel::merge(first1, last1, first2, last2, output, comp);
+}
+
+template <class Container1, class Container2,
+          class RandomAccessIterator>
+RandomAccessIterator merge_parallel(const Container1& container1,
+                                    const Container2& container2,
+                                    RandomAccessIterator output) {
+    return parallel::merge(begin(container1), end(container1),
+                           begin(container2), end(container2), output,
+                           batch::less());
+}
+
+template <class Container1, class Container2,
+          class RandomAccessIterator, class Compare>
+RandomAccessIterator merge_parallel_with(const Container1& container1,
+                                         const Container2& container2,
+                                         RandomAccessIterator output,
+                                         Compare comp) {
+    return parallel::merge(begin(container1), end(container1),
+                           begin(container2), end(container2), output,
+                           comp);
+}
+
+template <class Container, class RandomAccessIterator>
+void inplace_merge_parallel(Container& container,
+                            RandomAccessIterator middle) {
+    return parallel::inplace_merge(begin(container), middle,
+                                   end(container), batch::less());
+}
+
+template <class Container, class RandomAccessIterator, class Compare>
+void inplace_merge_parallel_with(Container& container,
+                                 RandomAccessIterator middle,
+                                 Compare comp) {
+    return parallel::inplace_merge(begin(container), middle,
+                                   end(container), comp);
+}
+
 template <class Container1, class Container2>
 bool includes(const Container1& container1, const Container2& container2) {
     return std::includes(begin(container1), end(container1),
@@ -1504,6 +1774,172 @@ bool includes_with(Iterator1 first1, Iterator1 last1,
     return std::includes(first1, last1, first2, last2, comp);
 }
 
+/// `merge` for random access ranges that notices when one side keeps
+/// winning and gallops through it instead, so merging `m` elements
+/// into `n` costs O(m log(n / m)) comparisons when `m` is much
+/// smaller.  Stable like `merge`.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator>
+OutputIterator merge_galloping(RandomAccessIterator1 first1,
+                               RandomAccessIterator1 last1,
+                               RandomAccessIterator2 first2,
+                               RandomAccessIterator2 last2,
+                               OutputIterator output) {
+    return gallop::merge(first1, last1, first2, last2, output,
+                         batch::less());
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator, class Compare>
+OutputIterator merge_galloping_with(RandomAccessIterator1 first1,
+                                    RandomAccessIterator1 last1,
+                                    RandomAccessIterator2 first2,
+                                    RandomAccessIterator2 last2,
+                                    OutputIterator output,
+                                    Compare comp) {
+    return gallop::merge(first1, last1, first2, last2, output, comp);
+}
+
+template <class Container1, class Container2, class OutputIterator>
+OutputIterator merge_galloping(const Container1& container1,
+                               const Container2& container2,
+                               OutputIterator output) {
+    return gallop::merge(begin(container1), end(container1),
+                         begin(container2), end(container2), output,
+                         batch::less());
+}
+
+template <class Container1, class Container2, class OutputIterator,
+          class Compare>
+OutputIterator merge_galloping_with(const Container1& container1,
+                                    const Container2& container2,
+                                    OutputIterator output,
+                                    Compare comp) {
+    return gallop::merge(begin(container1), end(container1),
+                         begin(container2), end(container2), output,
+                         comp);
+}
+
+/// `includes` that gallops through the first range to each element of
+/// the second.
+template <class RandomAccessIterator1, class RandomAccessIterator2>
+bool includes_galloping(RandomAccessIterator1 first1,
+                        RandomAccessIterator1 last1,
+                        RandomAccessIterator2 first2,
+                        RandomAccessIterator2 last2) {
+    return gallop::includes(first1, last1, first2, last2,
+                            batch::less());
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class Compare>
+bool includes_galloping_with(RandomAccessIterator1 first1,
+                             RandomAccessIterator1 last1,
+                             RandomAccessIterator2 first2,
+                             RandomAccessIterator2 last2, Compare comp) {
+    return gallop::includes(first1, last1, first2, last2, comp);
+}
+
+template <class Container1, class Container2>
+bool includes_galloping(const Container1& container1,
+                        const Container2& container2) {
+    return gallop::includes(begin(container1), end(container1),
+                            begin(container2), end(container2),
+                            batch::less());
+}
+
+template <class Container1, class Container2, class Compare>
+bool includes_galloping_with(const Container1& container1,
+                             const Container2& container2,
+                             Compare comp) {
+    return gallop::includes(begin(container1), end(container1),
+                            begin(container2), end(container2), comp);
+}
+
+/// `set_intersection` that gallops past runs with no match on the
+/// other side.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator>
+OutputIterator set_intersection_galloping(RandomAccessIterator1 first1,
+                                          RandomAccessIterator1 last1,
+                                          RandomAccessIterator2 first2,
+                                          RandomAccessIterator2 last2,
+                                          OutputIterator output) {
+    return gallop::set_intersection(first1, last1, first2, last2, output,
+                                    batch::less());
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator, class Compare>
+OutputIterator set_intersection_galloping_with(
+    RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+    RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+    OutputIterator output, Compare comp) {
+    return gallop::set_intersection(first1, last1, first2, last2, output,
+                                    comp);
+}
+
+template <class Container1, class Container2, class OutputIterator>
+OutputIterator set_intersection_galloping(const Container1& container1,
+                                          const Container2& container2,
+                                          OutputIterator output) {
+    return gallop::set_intersection(begin(container1), end(container1),
+                                    begin(container2), end(container2),
+                                    output, batch::less());
+}
+
+template <class Container1, class Container2, class OutputIterator,
+          class Compare>
+OutputIterator set_intersection_galloping_with(
+    const Container1& container1, const Container2& container2,
+    OutputIterator output, Compare comp) {
+    return gallop::set_intersection(begin(container1), end(container1),
+                                    begin(container2), end(container2),
+                                    output, comp);
+}
+
+/// `set_difference` that gallops past runs with no match on the other
+/// side.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator>
+OutputIterator set_difference_galloping(RandomAccessIterator1 first1,
+                                        RandomAccessIterator1 last1,
+                                        RandomAccessIterator2 first2,
+                                        RandomAccessIterator2 last2,
+                                        OutputIterator output) {
+    return gallop::set_difference(first1, last1, first2, last2, output,
+                                  batch::less());
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator, class Compare>
+OutputIterator set_difference_galloping_with(
+    RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+    RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+    OutputIterator output, Compare comp) {
+    return gallop::set_difference(first1, last1, first2, last2, output,
+                                  comp);
+}
+
+template <class Container1, class Container2, class OutputIterator>
+OutputIterator set_difference_galloping(const Container1& container1,
+                                        const Container2& container2,
+                                        OutputIterator output) {
+    return gallop::set_difference(begin(container1), end(container1),
+                                  begin(container2), end(container2),
+                                  output, batch::less());
+}
+
+template <class Container1, class Container2, class OutputIterator,
+          class Compare>
+OutputIterator set_difference_galloping_with(
+    const Container1& container1, const Container2& container2,
+    OutputIterator output, Compare comp) {
+    return gallop::set_difference(begin(container1), end(container1),
+                                  begin(container2), end(container2),
+                                  output, comp);
+}
+
 template <class Container1, class Container2, class OutputIterator>
 OutputIterator set_union(const Container1& container1,
                          const Container2& container2,
@@ -1522,23 +1958,27 @@ OutputIterator set_union_with(const Container1& container1,
                           comp);
 }
 
-template <class Container, class OutputIterator>
+template <class Container>
 Container set_union(const Container& container1,
                     const Container& container2) {
     Container result;
+    reserve_result(result, container1.size() + container2.size());
     std::set_union(begin(container1), end(container1),
                    begin(container2), end(container2),
                    std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
-template <class Container, class OutputIterator, class Compare>
+template <class Container, class Compare>
 Container set_union_with(const Container& container1,
                          const Container& container2, Compare comp) {
     Container result;
+    reserve_result(result, container1.size() + container2.size());
     std::set_union(begin(container1), end(container1),
                    begin(container2), end(container2),
                    std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -1549,7 +1989,7 @@ Container set_union_with(const Container& container1,
 // Container set_union(InputIterator first1, InputIterator last1,
 //                     InputIterator first2, InputIterator last2)
 // #else
-template <class Container, class Compare>
+template <class Container>
 Container set_union(typename iterator_type_of<Container>::type first1,
                     typename iterator_type_of<Container>::type last1,
                     typename iterator_type_of<Container>::type first2,
@@ -1557,8 +1997,11 @@ Container set_union(typename iterator_type_of<Container>::type first1,
 // #endif
 {
     Container result;
+    reserve_result(result,
+                   size_hint(first1, last1) + size_hint(first2, last2));
     std::set_union(first1, last1, first2, last2,
                    std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
@@ -1580,8 +2023,11 @@ Container set_union_with(
 // #endif
 {
     Container result;
+    reserve_result(result,
+                   size_hint(first1, last1) + size_hint(first2, last2));
     std::set_union(first1, last1, first2, last2,
                    std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -1607,9 +2053,9 @@ template <class Container1, class Container2, class OutputIterator>
 OutputIterator set_intersection(const Container1& container1,
                                 const Container2& container2,
                                 OutputIterator output) {
-    return std::set_intersection(begin(container1), end(container1),
-                                 begin(container2), end(container2),
-                                 output);
+    return simd::set_intersection(begin(container1), end(container1),
+                                  begin(container2), end(container2),
+                                  output);
 }
 
 template <class Container1, class Container2, class OutputIterator,
@@ -1623,24 +2069,28 @@ OutputIterator set_intersection_with(const Container1& container1,
                                  output, comp);
 }
 
-template <class Container, class OutputIterator>
+template <class Container>
 Container set_intersection(const Container& container1,
                            const Container& container2) {
     Container result;
-    std::set_intersection(begin(container1), end(container1),
-                          begin(container2), end(container2),
-                          std::back_inserter(result));
+    reserve_result(result, std::min(container1.size(), container2.size()));
+    simd::set_intersection(begin(container1), end(container1),
+                           begin(container2), end(container2),
+                           std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
-template <class Container, class OutputIterator, class Compare>
+template <class Container, class Compare>
 Container set_intersection_with(const Container& container1,
                                 const Container& container2,
                                 Compare comp) {
     Container result;
+    reserve_result(result, std::min(container1.size(), container2.size()));
     std::set_intersection(begin(container1), end(container1),
                           begin(container2), end(container2),
                           std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -1657,8 +2107,11 @@ Container set_intersection(typename iterator_type_of<Container>::type first1,
                            typename iterator_type_of<Container>::type last2)
 {
     Container result;
-    std::set_intersection(first1, last1, first2, last2,
-                          std::back_inserter(result));
+    reserve_result(result,
+                   std::min(size_hint(first1, last1), size_hint(first2, last2)));
+    simd::set_intersection(first1, last1, first2, last2,
+                           std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
@@ -1677,8 +2130,11 @@ Container set_intersection(typename iterator_type_of<Container>::type first1,
                            Compare comp)
 {
     Container result;
+    reserve_result(result,
+                   std::min(size_hint(first1, last1), size_hint(first2, last2)));
     std::set_intersection(first1, last1, first2, last2,
                           std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -1689,8 +2145,8 @@ OutputIterator set_intersection(InputIterator1 first1,
                                 InputIterator2 first2,
                                 InputIterator2 last2,
                                 OutputIterator output) {
-    return std::set_intersection(first1, last1, first2, last2,
-                                 output);
+    return simd::set_intersection(first1, last1, first2, last2,
+                                  output);
 }
 
 template <class InputIterator1, class InputIterator2,
@@ -1709,9 +2165,9 @@ template <class Container1, class Container2, class OutputIterator>
 OutputIterator set_difference(const Container1& container1,
                               const Container2& container2,
                               OutputIterator output) {
-    return std::set_difference(begin(container1), end(container1),
-                               begin(container2), end(container2),
-                               output);
+    return simd::set_difference(begin(container1), end(container1),
+                                begin(container2), end(container2),
+                                output);
 }
 
 template <class Container1, class Container2, class OutputIterator,
@@ -1725,24 +2181,28 @@ OutputIterator set_difference_with(const Container1& container1,
                                output, comp);
 }
 
-template <class Container, class OutputIterator>
+template <class Container>
 Container set_difference(const Container& container1,
                          const Container& container2) {
     Container result;
-    std::set_difference(begin(container1), end(container1),
-                        begin(container2), end(container2),
-                        std::back_inserter(result));
+    reserve_result(result, container1.size());
+    simd::set_difference(begin(container1), end(container1),
+                         begin(container2), end(container2),
+                         std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
-template <class Container, class OutputIterator, class Compare>
+template <class Container, class Compare>
 Container set_difference_with(const Container& container1,
                               const Container& container2,
                               Compare comp) {
     Container result;
+    reserve_result(result, container1.size());
     std::set_difference(begin(container1), end(container1),
                         begin(container2), end(container2),
                         std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -1758,8 +2218,10 @@ Container set_difference(
     typename iterator_type_of<Container>::type first2,
     typename iterator_type_of<Container>::type last2) {
     Container result;
-    std::set_difference(first1, last1, first2, last2,
-                        std::back_inserter(result));
+    reserve_result(result, size_hint(first1, last1));
+    simd::set_difference(first1, last1, first2, last2,
+                         std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
@@ -1778,8 +2240,10 @@ Container set_difference_with(
     typename iterator_type_of<Container>::type last2,
     Compare comp) {
     Container result;
+    reserve_result(result, size_hint(first1, last1));
     std::set_difference(first1, last1, first2, last2,
                         std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -1790,7 +2254,7 @@ OutputIterator set_difference(InputIterator1 first1,
                               InputIterator2 first2,
                               InputIterator2 last2,
                               OutputIterator output) {
-    return std::set_difference(first1, last1, first2, last2, output);
+    return simd::set_difference(first1, last1, first2, last2, output);
 }
 
 template <class InputIterator1, class InputIterator2,
@@ -1828,24 +2292,28 @@ OutputIterator set_symmetric_difference_with(const Container1& container1,
                                          comp);
 }
 
-template <class Container, class OutputIterator>
+template <class Container>
 Container set_symmetric_difference(const Container& container1,
                                    const Container& container2) {
     Container result;
+    reserve_result(result, container1.size() + container2.size());
     std::set_symmetric_difference(begin(container1), end(container1),
                                   begin(container2), end(container2),
                                   std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
-template <class Container, class OutputIterator, class Compare>
+template <class Container, class Compare>
 Container set_symmetric_difference_with(const Container& container1,
                                         const Container& container2,
                                         Compare comp) {
     Container result;
+    reserve_result(result, container1.size() + container2.size());
     std::set_symmetric_difference(begin(container1), end(container1),
                                   begin(container2), end(container2),
                                   std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -1863,8 +2331,11 @@ Container set_symmetric_difference(
     typename iterator_type_of<Container>::type first2,
     typename iterator_type_of<Container>::type last2) {
     Container result;
+    reserve_result(result,
+                   size_hint(first1, last1) + size_hint(first2, last2));
     std::set_symmetric_difference(first1, last1, first2, last2,
                                   std::back_inserter(result));
+    shrink_result(result);
     return result;
 }
 
@@ -1884,8 +2355,11 @@ Container set_symmetric_difference_with(
     typename iterator_type_of<Container>::type last2,
     Compare comp) {
     Container result;
+    reserve_result(result,
+                   size_hint(first1, last1) + size_hint(first2, last2));
     std::set_symmetric_difference(first1, last1, first2, last2,
                                   std::back_inserter(result), comp);
+    shrink_result(result);
     return result;
 }
 
@@ -2025,10 +2499,7 @@ void sort_heap_with(RandomAccessIterator first,
 }
 
 #if __cplusplus >= 201103L
-template <class RandomAccessIterator>
-bool is_heap(RandomAccessIterator first, RandomAccessIterator last) {
-    return std::is_heap(first, last);
-}
+using ::std::is_heap;
 
 template <class RandomAccessIterator, class Compare>
 bool is_heap_with(RandomAccessIterator first,
@@ -2077,10 +2548,7 @@ bool is_heap_with(const Container& container, Compare comp) {
 }
 
 #if __cplusplus >= 201103L
-template <class RandomAccessIterator>
-RandomAccessIterator is_heap_until(RandomAccessIterator first, RandomAccessIterator last) {
-    return std::is_heap_until(first, last);
-}
+using ::std::is_heap_until;
 
 template <class RandomAccessIterator, class Compare>
 RandomAccessIterator is_heap_until_with(RandomAccessIterator first,
@@ -2119,7 +2587,7 @@ RandomAccessIterator is_heap_until_with(RandomAccessIterator first, RandomAccess
 #endif
 
 template <class Container>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
     is_heap_until(const Container& container)
     #if __cplusplus >= 201103L
     -> decltype(std::is_heap_until(begin(container),
@@ -2130,7 +2598,7 @@ IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
 }
 
 template <class Container, class Compare>
-IF_CPLUSPLUS_11(auto, typename iterator_type_of<Container>::type)
+IF_CPLUSPLUS_11(auto, typename iterator_type_of<const Container>::type)
     is_heap_until_with(const Container& container, Compare comp)
     #if __cplusplus >= 201103L
     -> decltype(std::is_heap_until(begin(container), end(container),
@@ -2375,38 +2843,117 @@ bool prev_permutation_with(BidirectionalIterator first,
 /////////////////////////
 /// MY OWN ALGORITHMS ///
 /////////////////////////
+template <class InputIterator, class OutputIterator>
+OutputIterator copy_elements(InputIterator first, InputIterator last,
+                             OutputIterator output, true_type) {
+    typedef typename std::iterator_traits<InputIterator>::value_type
+        value_type;
+    size_t n = last - first;
+    if (n != 0) {
+        memcpy(&*output, &*first, n * sizeof(value_type));
+    }
+    return output + n;
+}
+
+template <class InputIterator, class OutputIterator>
+OutputIterator copy_elements(InputIterator first, InputIterator last,
+                             OutputIterator output, false_type) {
+    return std::copy(first, last, output);
+}
+
+/// `std::copy` that is a single `memcpy` when both sides are
+/// contiguous arrays of the same trivially copyable type.
+template <class InputIterator, class OutputIterator>
+OutputIterator copy_elements(InputIterator first, InputIterator last,
+                             OutputIterator output) {
+    typedef typename std::iterator_traits<InputIterator>::value_type
+        value_type;
+    return copy_elements(
+        first, last, output,
+        integral_constant<
+            bool,
+            is_contiguous_iterator<InputIterator>::value and
+                is_contiguous_iterator<OutputIterator>::value and
+                is_same<value_type,
+                        typename std::iterator_traits<
+                            OutputIterator>::value_type>::value and
+                is_trivially_copyable<value_type>::value>());
+}
+
+#if __cplusplus >= 201103L
 template <class Container1, class Container2>
-void append(Container1& container1, const Container2& container2) {
-    container1.reserve(container1.size() + container2.size());
-    for (typename iterator_type_of<Container1>::type it =
-             begin(container2);
-         it != end(container2); ++it) {
-        container1.push_back(*it);
+void append_elements(Container1& container1, Container2& container2,
+                     true_type) {
+    container1.insert(end(container1), begin(container2),
+                      end(container2));
+}
+
+template <class Container1, class Container2>
+void append_elements(Container1& container1, Container2& container2,
+                     false_type) {
+    container1.insert(end(container1),
+                      std::make_move_iterator(begin(container2)),
+                      std::make_move_iterator(end(container2)));
+}
+
+template <class Container>
+void append_elements(Container& container1, Container& container2,
+                     false_type) {
+    // nothing to append to: take the whole buffer instead.
+    if (container1.empty()) {
+        container1 = std::move(container2);
+        return;
     }
+    container1.insert(end(container1),
+                      std::make_move_iterator(begin(container2)),
+                      std::make_move_iterator(end(container2)));
+}
+#endif
+
+/// appends `container2` to `container1` with one range insert, so
+/// `container1` grows at most once and trivially copyable elements
+/// are copied as a block.  The elements of an rvalue `container2` are
+/// moved instead.  `container2` must not be `container1`.
+template <class Container1, class Container2>
+void append(Container1& container1,
+            IF_CPLUSPLUS_11(Container2&&, const Container2&) container2) {
+#if __cplusplus >= 201103L
+    append_elements(
+        container1, container2,
+        integral_constant<bool,
+                          std::is_lvalue_reference<Container2>::value>());
+#else
+    container1.insert(end(container1), begin(container2),
+                      end(container2));
+#endif
 }
 
+/// writes `container1` and then `container2` to `output`.
 template <class Container1, class Container2, class OutputIterator>
-void append_copy(const Container1& container1, const Container2& container2,
-                 OutputIterator output) {
-    for (typename iterator_type_of<Container1>::type it = begin(container1); it != end(container1); ++it) {
-        *output++ = *it;
-    }
-    for (typename iterator_type_of<Container2>::type it = begin(container2); it != end(container2); ++it) {
-        *output++ = *it;
-    }
+OutputIterator append_copy(const Container1& container1,
+                           const Container2& container2,
+                           OutputIterator output) {
+    return copy_elements(begin(container2), end(container2),
+                         copy_elements(begin(container1),
+                                       end(container1), output));
+}
+
+/// replaces the contents of `output` with `container1` followed by
+/// `container2`, reusing the storage `output` already has.
+template <class Container1, class Container2, class Container>
+void append_copy_into(const Container1& container1,
+                      const Container2& container2, Container& output) {
+    output.clear();
+    output.reserve(container1.size() + container2.size());
+    append(output, container1);
+    append(output, container2);
 }
 
 template <class Container1, class Container2>
 Container1 append_copy(const Container1& container1,
                        const Container2& container2) {
     Container1 result;
-    result.reserve(container1.size() + container2.size());
-    for (typename iterator_type_of<Container1>::type it = begin(container1); it != end(container1); ++it) {
-        result.push_back(*it);
-    }
-    for (typename iterator_type_of<Container2>::type it = begin(container2); it != end(container2); ++it) {
-        result.push_back(*it);
-    }
+    append_copy_into(container1, container2, result);
     return result;
 }
 
@@ -0,0 +1,167 @@
+#ifndef HEADER_GUARD_BATCH_SEARCH_H
+#define HEADER_GUARD_BATCH_SEARCH_H
+
+#include <stddef.h>
+#include <iterator>
+
+namespace prelude {
+namespace batch {
+
+struct less {
+    template <class A, class B>
+    bool operator()(const A& a, const B& b) const {
+        return a < b;
+    }
+};
+
+// `lower_bound` looks for the first element not before the key,
+// `upper_bound` for the first element the key is before.
+template <class Compare, bool Upper>
+struct goes_before;
+
+template <class Compare>
+struct goes_before<Compare, false> {
+    Compare comp;
+    template <class Element, class Key>
+    bool operator()(const Element& element, const Key& key) const {
+        return comp(element, key);
+    }
+};
+
+template <class Compare>
+struct goes_before<Compare, true> {
+    Compare comp;
+    template <class Element, class Key>
+    bool operator()(const Element& element, const Key& key) const {
+        return not comp(key, element);
+    }
+};
+
+template <class RandomAccessIterator>
+void prefetch(RandomAccessIterator it) {
+#if defined(__GNUC__) or defined(__clang__)
+    __builtin_prefetch(&*it);
+#else
+    (void)it;
+#endif
+}
+
+// Branch free search of `[first + lo, first + hi)`: the probes only
+// depend on the length, so the compiler can use conditional moves.
+template <class RandomAccessIterator, class Key, class Before>
+size_t search_one(RandomAccessIterator first, size_t lo, size_t hi,
+                  const Key& key, Before before) {
+    size_t len = hi - lo;
+    if (len == 0) {
+        return lo;
+    }
+    size_t base = lo;
+    while (len > 1) {
+        size_t half = len / 2;
+        base += before(first[base + half], key) ? half : 0;
+        len -= half;
+    }
+    return base + before(first[base], key);
+}
+
+// Ascending keys: every answer is at or after the previous one, so
+// gallop forward from there instead of starting over.
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator, class Before>
+OutputIterator search_sorted(RandomAccessIterator first, size_t n,
+                             ForwardIterator keys_first,
+                             ForwardIterator keys_last,
+                             OutputIterator output, Before before) {
+    size_t lo = 0;
+    for (; keys_first != keys_last; ++keys_first) {
+        size_t hi = lo;
+        size_t step = 1;
+        while (hi < n and before(first[hi], *keys_first)) {
+            lo = hi + 1;
+            hi = lo + step;
+            step *= 2;
+        }
+        lo = search_one(first, lo, hi < n ? hi : n, *keys_first, before);
+        *output = first + lo;
+        ++output;
+    }
+    return output;
+}
+
+// Up to `group` searches descend together, so their cache misses
+// overlap instead of each one waiting on the last.
+template <class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator, class Before>
+OutputIterator search_interleaved(RandomAccessIterator first, size_t n,
+                                  ForwardIterator keys_first,
+                                  ForwardIterator keys_last,
+                                  OutputIterator output, Before before) {
+    const size_t group = 16;
+    ForwardIterator keys[group];
+    size_t base[group];
+    while (keys_first != keys_last) {
+        size_t m = 0;
+        for (; m < group and keys_first != keys_last;
+             ++m, ++keys_first) {
+            keys[m] = keys_first;
+            base[m] = 0;
+        }
+        if (n != 0) {
+            size_t len = n;
+            while (len > 1) {
+                size_t half = len / 2;
+                size_t next_half = (len - half) / 2;
+                for (size_t g = 0; g < m; ++g) {
+                    prefetch(first + (base[g] + next_half));
+                    prefetch(first + (base[g] + half + next_half));
+                }
+                for (size_t g = 0; g < m; ++g) {
+                    base[g] +=
+                        before(first[base[g] + half], *keys[g]) ? half : 0;
+                }
+                len -= half;
+            }
+            for (size_t g = 0; g < m; ++g) {
+                base[g] += before(first[base[g]], *keys[g]);
+            }
+        }
+        for (size_t g = 0; g < m; ++g) {
+            *output = first + base[g];
+            ++output;
+        }
+    }
+    return output;
+}
+
+template <bool Upper, class RandomAccessIterator, class ForwardIterator,
+          class OutputIterator, class Compare>
+OutputIterator search(RandomAccessIterator first,
+                      RandomAccessIterator last,
+                      ForwardIterator keys_first,
+                      ForwardIterator keys_last, OutputIterator output,
+                      Compare comp) {
+    goes_before<Compare, Upper> before = {comp};
+    size_t n = last - first;
+    bool sorted = true;
+    if (keys_first != keys_last) {
+        ForwardIterator previous = keys_first;
+        for (ForwardIterator it = previous; ++it != keys_last;
+             previous = it) {
+            if (comp(*it, *previous)) {
+                sorted = false;
+                break;
+            }
+        }
+    }
+    if (sorted) {
+        return search_sorted(first, n, keys_first, keys_last, output,
+                             before);
+    }
+    return search_interleaved(first, n, keys_first, keys_last, output,
+                              before);
+}
+
+}
+}
+
+#endif
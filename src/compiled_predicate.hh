@@ -0,0 +1,490 @@
+#ifndef HEADER_GUARD_COMPILED_PREDICATE_H
+#define HEADER_GUARD_COMPILED_PREDICATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include "metaprogramming.hh"
+#include "predicate.hh"
+#include "simd.hh"
+#include "type_traits.hh"
+
+namespace prelude {
+/// Trees of predicates built with `and`, `or` and `not` are compiled
+/// into programs that test a block of up to 64 elements at once and
+/// return a mask with bit `i` set when element `i` matches.  Every
+/// clause runs over the whole block and the masks are combined with
+/// bitwise operations, so there are no branches left to mispredict on
+/// random data.  The algorithms below take the compiled path for
+/// contiguous arithmetic ranges.
+namespace compiled {
+
+typedef uint64_t mask_type;
+const size_t block_size = 64;
+
+inline mask_type first_bits(size_t n) {
+    return n >= block_size ? ~mask_type(0) : (mask_type(1) << n) - 1;
+}
+
+inline size_t popcount(mask_type mask) {
+#if defined(__GNUC__) or defined(__clang__)
+    return __builtin_popcountll(mask);
+#else
+    size_t count = 0;
+    for (; mask; mask &= mask - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// position of the lowest set bit of a nonzero `mask`.
+inline size_t lowest_bit(mask_type mask) {
+#if defined(__GNUC__) or defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    size_t i = 0;
+    for (; not(mask & 1); mask >>= 1) {
+        ++i;
+    }
+    return i;
+#endif
+}
+
+/// runs on the simd compare kernels when `Comp` is one of the
+/// standard comparisons and the elements are `T`s.
+template <class T, class Comp>
+struct Compare {
+    T operand;
+    Comp comp;
+
+    template <class U>
+    mask_type eval(const U* x, size_t n) const {
+        return eval(
+            x, n,
+            integral_constant<
+                bool, is_same<U, T>::value and
+                          simd::is_vectorizable<T>::value and
+                          simd::comparison_of<Comp, T>::value !=
+                              simd::cmp_none>());
+    }
+
+    mask_type eval(const T* x, size_t n, true_type) const {
+        return simd::compare_mask<simd::comparison_of<Comp, T>::value>(
+            x, n, operand);
+    }
+
+    template <class U>
+    mask_type eval(const U* x, size_t n, false_type) const {
+        unsigned char flags[block_size];
+        for (size_t i = 0; i < n; ++i) {
+            flags[i] = comp(x[i], operand);
+        }
+        return simd::pack_flags(flags, n);
+    }
+};
+
+template <class Program1, class Program2>
+struct And {
+    Program1 program1;
+    Program2 program2;
+
+    template <class U>
+    mask_type eval(const U* x, size_t n) const {
+        return program1.eval(x, n) & program2.eval(x, n);
+    }
+};
+
+template <class Program1, class Program2>
+struct Or {
+    Program1 program1;
+    Program2 program2;
+
+    template <class U>
+    mask_type eval(const U* x, size_t n) const {
+        return program1.eval(x, n) | program2.eval(x, n);
+    }
+};
+
+template <class Program>
+struct Not {
+    Program program;
+
+    template <class U>
+    mask_type eval(const U* x, size_t n) const {
+        return ~program.eval(x, n) & first_bits(n);
+    }
+};
+
+/// any other predicate, still called without branching on its result.
+template <class Pred>
+struct Opaque {
+    Pred pred;
+
+    template <class U>
+    mask_type eval(const U* x, size_t n) const {
+        unsigned char flags[block_size];
+        for (size_t i = 0; i < n; ++i) {
+            flags[i] = static_cast<bool>(pred(x[i]));
+        }
+        return simd::pack_flags(flags, n);
+    }
+};
+
+/// runs on the simd divisibility kernel when the elements are `T`s.
+template <class T>
+struct Divisible {
+    DivisibilityPredicate<T> pred;
+
+    template <class U>
+    mask_type eval(const U* x, size_t n) const {
+        return eval(x, n, integral_constant<bool, is_same<U, T>::value>());
+    }
+
+    mask_type eval(const T* x, size_t n, true_type) const {
+        return simd::divisible_mask(x, n, pred);
+    }
+
+    template <class U>
+    mask_type eval(const U* x, size_t n, false_type) const {
+        unsigned char flags[block_size];
+        for (size_t i = 0; i < n; ++i) {
+            flags[i] = pred(x[i]);
+        }
+        return simd::pack_flags(flags, n);
+    }
+};
+
+/// `type` is the program for `Pred`, made by `compile`.  `value` is
+/// false for predicates we know nothing about.
+template <class Pred>
+struct compiler : false_type {
+    typedef Opaque<Pred> type;
+    static type compile(const Pred& pred) {
+        type program = {pred};
+        return program;
+    }
+};
+
+template <class T, class Comp>
+struct compiler<BinaryPredicate<T, Comp> > : true_type {
+    typedef Compare<T, Comp> type;
+    static type compile(const BinaryPredicate<T, Comp>& pred) {
+        type program = {pred.operand(), pred.comparison()};
+        return program;
+    }
+};
+
+template <class T, T N, class Comp>
+struct compiler<ConstantPredicate<T, N, Comp> > : true_type {
+    typedef Compare<T, Comp> type;
+    static type compile(const ConstantPredicate<T, N, Comp>&) {
+        type program = {N, Comp()};
+        return program;
+    }
+};
+
+template <class T>
+struct compiler<DivisibilityPredicate<T> > : true_type {
+    typedef Divisible<T> type;
+    static type compile(const DivisibilityPredicate<T>& pred) {
+        type program = {pred};
+        return program;
+    }
+};
+
+template <class T, class Pred1, class Pred2>
+struct compiler<
+    CombinatoryPredicate<T, Pred1, Pred2, std::logical_and<bool> > >
+    : true_type {
+    typedef And<typename compiler<Pred1>::type,
+                typename compiler<Pred2>::type>
+        type;
+    static type compile(
+        const CombinatoryPredicate<T, Pred1, Pred2,
+                                   std::logical_and<bool> >& pred) {
+        type program = {compiler<Pred1>::compile(pred.left()),
+                        compiler<Pred2>::compile(pred.right())};
+        return program;
+    }
+};
+
+template <class T, class Pred1, class Pred2>
+struct compiler<
+    CombinatoryPredicate<T, Pred1, Pred2, std::logical_or<bool> > >
+    : true_type {
+    typedef Or<typename compiler<Pred1>::type,
+               typename compiler<Pred2>::type>
+        type;
+    static type compile(
+        const CombinatoryPredicate<T, Pred1, Pred2,
+                                   std::logical_or<bool> >& pred) {
+        type program = {compiler<Pred1>::compile(pred.left()),
+                        compiler<Pred2>::compile(pred.right())};
+        return program;
+    }
+};
+
+template <class Pred>
+struct compiler<NotPredicate<Pred> > : true_type {
+    typedef Not<typename compiler<Pred>::type> type;
+    static type compile(const NotPredicate<Pred>& pred) {
+        type program = {compiler<Pred>::compile(pred.negated())};
+        return program;
+    }
+};
+
+template <class Pred>
+typename compiler<Pred>::type compile(const Pred& pred) {
+    return compiler<Pred>::compile(pred);
+}
+
+template <class T, class Program>
+size_t count(const T* first, size_t n, const Program& program) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += block_size) {
+        count += popcount(
+            program.eval(first + i, std::min(block_size, n - i)));
+    }
+    return count;
+}
+
+/// index of the first match, or `n`.
+template <class T, class Program>
+size_t find(const T* first, size_t n, const Program& program) {
+    for (size_t i = 0; i < n; i += block_size) {
+        mask_type mask =
+            program.eval(first + i, std::min(block_size, n - i));
+        if (mask) {
+            return i + lowest_bit(mask);
+        }
+    }
+    return n;
+}
+
+/// index of the first element not matching, or `n`.
+template <class T, class Program>
+size_t find_not(const T* first, size_t n, const Program& program) {
+    for (size_t i = 0; i < n; i += block_size) {
+        size_t m = std::min(block_size, n - i);
+        mask_type mask = program.eval(first + i, m) ^ first_bits(m);
+        if (mask) {
+            return i + lowest_bit(mask);
+        }
+    }
+    return n;
+}
+
+/// writes the index of every match to `output`.
+template <class T, class Program, class OutputIterator>
+OutputIterator select(const T* first, size_t n, const Program& program,
+                      OutputIterator output) {
+    for (size_t i = 0; i < n; i += block_size) {
+        mask_type mask =
+            program.eval(first + i, std::min(block_size, n - i));
+        for (; mask; mask &= mask - 1) {
+            *output = i + lowest_bit(mask);
+            ++output;
+        }
+    }
+    return output;
+}
+
+// Every element is written, matches just don't advance the output.
+template <class T, class Program>
+size_t remove(T* first, size_t n, const Program& program) {
+    size_t kept = 0;
+    for (size_t i = 0; i < n; i += block_size) {
+        size_t m = std::min(block_size, n - i);
+        mask_type mask = program.eval(first + i, m);
+        for (size_t j = 0; j < m; ++j) {
+            first[kept] = first[i + j];
+            kept += not((mask >> j) & 1);
+        }
+    }
+    return kept;
+}
+
+// Lomuto's scheme with the tests done up front: every element is
+// swapped, matches advance the boundary.  Only elements behind the
+// current one move, so the rest of the block's mask stays right.
+template <class T, class Program>
+size_t partition(T* first, size_t n, const Program& program) {
+    size_t boundary = 0;
+    for (size_t i = 0; i < n; i += block_size) {
+        size_t m = std::min(block_size, n - i);
+        mask_type mask = program.eval(first + i, m);
+        for (size_t j = 0; j < m; ++j) {
+            std::swap(first[boundary], first[i + j]);
+            boundary += (mask >> j) & 1;
+        }
+    }
+    return boundary;
+}
+
+template <class Iterator, class Pred>
+struct is_compilable
+    : integral_constant<
+          bool, compiler<Pred>::value and
+                    is_contiguous_iterator<Iterator>::value and
+                    is_arithmetic<typename std::iterator_traits<
+                        Iterator>::value_type>::value> {};
+
+template <class Iterator, class UnaryPredicate>
+typename std::iterator_traits<Iterator>::difference_type count_if(
+    Iterator first, Iterator last, UnaryPredicate pred, true_type) {
+    if (first == last) {
+        return 0;
+    }
+    return count(&*first, last - first, compile(pred));
+}
+
+template <class Iterator, class UnaryPredicate>
+typename std::iterator_traits<Iterator>::difference_type count_if(
+    Iterator first, Iterator last, UnaryPredicate pred, false_type) {
+    return simd::count_if(first, last, pred);
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator find_if(Iterator first, Iterator last, UnaryPredicate pred,
+                 true_type) {
+    if (first == last) {
+        return last;
+    }
+    return first + find(&*first, last - first, compile(pred));
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator find_if(Iterator first, Iterator last, UnaryPredicate pred,
+                 false_type) {
+    return std::find_if(first, last, pred);
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator remove_if(Iterator first, Iterator last, UnaryPredicate pred,
+                   true_type) {
+    if (first == last) {
+        return last;
+    }
+    return first + remove(&*first, last - first, compile(pred));
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator remove_if(Iterator first, Iterator last, UnaryPredicate pred,
+                   false_type) {
+    return std::remove_if(first, last, pred);
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator partition(Iterator first, Iterator last, UnaryPredicate pred,
+                   true_type) {
+    if (first == last) {
+        return last;
+    }
+    return first + partition(&*first, last - first, compile(pred));
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator partition(Iterator first, Iterator last, UnaryPredicate pred,
+                   false_type) {
+    return std::partition(first, last, pred);
+}
+
+template <class Iterator, class UnaryPredicate, class OutputIterator>
+OutputIterator select(Iterator first, Iterator last, UnaryPredicate pred,
+                      OutputIterator output, true_type) {
+    if (first == last) {
+        return output;
+    }
+    return select(&*first, last - first, compile(pred), output);
+}
+
+template <class Iterator, class UnaryPredicate, class OutputIterator>
+OutputIterator select(Iterator first, Iterator last, UnaryPredicate pred,
+                      OutputIterator output, false_type) {
+    for (size_t i = 0; first != last; ++first, ++i) {
+        if (pred(*first)) {
+            *output = i;
+            ++output;
+        }
+    }
+    return output;
+}
+
+template <class Iterator, class UnaryPredicate>
+bool all_of(Iterator first, Iterator last, UnaryPredicate pred,
+            true_type) {
+    if (first == last) {
+        return true;
+    }
+    size_t n = last - first;
+    return find_not(&*first, n, compile(pred)) == n;
+}
+
+template <class Iterator, class UnaryPredicate>
+bool all_of(Iterator first, Iterator last, UnaryPredicate pred,
+            false_type) {
+    for (; first != last; ++first) {
+        if (not pred(*first)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// qualified calls, or the tags would find `std::` through ADL.
+template <class Iterator, class UnaryPredicate>
+typename std::iterator_traits<Iterator>::difference_type count_if(
+    Iterator first, Iterator last, UnaryPredicate pred) {
+    return compiled::count_if(
+        first, last, pred, is_compilable<Iterator, UnaryPredicate>());
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator find_if(Iterator first, Iterator last, UnaryPredicate pred) {
+    return compiled::find_if(first, last, pred,
+                             is_compilable<Iterator, UnaryPredicate>());
+}
+
+template <class Iterator, class UnaryPredicate>
+bool all_of(Iterator first, Iterator last, UnaryPredicate pred) {
+    return compiled::all_of(first, last, pred,
+                            is_compilable<Iterator, UnaryPredicate>());
+}
+
+template <class Iterator, class UnaryPredicate>
+bool any_of(Iterator first, Iterator last, UnaryPredicate pred) {
+    return compiled::find_if(first, last, pred) != last;
+}
+
+template <class Iterator, class UnaryPredicate>
+bool none_of(Iterator first, Iterator last, UnaryPredicate pred) {
+    return compiled::find_if(first, last, pred) == last;
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator remove_if(Iterator first, Iterator last, UnaryPredicate pred) {
+    return compiled::remove_if(
+        first, last, pred, is_compilable<Iterator, UnaryPredicate>());
+}
+
+template <class Iterator, class UnaryPredicate>
+Iterator partition(Iterator first, Iterator last, UnaryPredicate pred) {
+    return compiled::partition(
+        first, last, pred, is_compilable<Iterator, UnaryPredicate>());
+}
+
+/// writes the index of every element matching `pred` to `output`.
+template <class Iterator, class UnaryPredicate, class OutputIterator>
+OutputIterator select(Iterator first, Iterator last, UnaryPredicate pred,
+                      OutputIterator output) {
+    return compiled::select(first, last, pred, output,
+                            is_compilable<Iterator, UnaryPredicate>());
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef HEADER_GUARD_GALLOP_H
+#define HEADER_GUARD_GALLOP_H
+
+#include <stddef.h>
+#include <algorithm>
+#include <iterator>
+
+namespace prelude {
+namespace gallop {
+
+// `lower_bound` and `upper_bound` that start looking at `first` and
+// double their step, so an answer `d` elements in costs O(log d)
+// comparisons no matter how long the range is.
+template <class RandomAccessIterator, class T, class Compare>
+RandomAccessIterator lower_bound(RandomAccessIterator first,
+                                 RandomAccessIterator last, const T& val,
+                                 Compare comp) {
+    ptrdiff_t n = last - first;
+    ptrdiff_t lo = 0;
+    ptrdiff_t hi = 1;
+    while (hi <= n and comp(first[hi - 1], val)) {
+        lo = hi;
+        hi = 2 * hi + 1;
+    }
+    return std::lower_bound(first + lo, first + (hi < n ? hi : n), val,
+                            comp);
+}
+
+template <class RandomAccessIterator, class T, class Compare>
+RandomAccessIterator upper_bound(RandomAccessIterator first,
+                                 RandomAccessIterator last, const T& val,
+                                 Compare comp) {
+    ptrdiff_t n = last - first;
+    ptrdiff_t lo = 0;
+    ptrdiff_t hi = 1;
+    while (hi <= n and not comp(val, first[hi - 1])) {
+        lo = hi;
+        hi = 2 * hi + 1;
+    }
+    return std::upper_bound(first + lo, first + (hi < n ? hi : n), val,
+                            comp);
+}
+
+// After this many wins in a row from one side we expect a long run and
+// start galloping, like TimSort does.
+const size_t min_gallop = 7;
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator, class Compare>
+OutputIterator merge(RandomAccessIterator1 first1,
+                     RandomAccessIterator1 last1,
+                     RandomAccessIterator2 first2,
+                     RandomAccessIterator2 last2, OutputIterator output,
+                     Compare comp) {
+    size_t wins1 = 0;
+    size_t wins2 = 0;
+    while (first1 != last1 and first2 != last2) {
+        if (wins1 >= min_gallop) {
+            // equal elements of the first range go first.
+            RandomAccessIterator1 run =
+                gallop::upper_bound(first1, last1, *first2, comp);
+            output = std::copy(first1, run, output);
+            first1 = run;
+            wins1 = 0;
+        } else if (wins2 >= min_gallop) {
+            RandomAccessIterator2 run =
+                gallop::lower_bound(first2, last2, *first1, comp);
+            output = std::copy(first2, run, output);
+            first2 = run;
+            wins2 = 0;
+        } else if (comp(*first2, *first1)) {
+            *output = *first2;
+            ++output;
+            ++first2;
+            ++wins2;
+            wins1 = 0;
+        } else {
+            *output = *first1;
+            ++output;
+            ++first1;
+            ++wins1;
+            wins2 = 0;
+        }
+    }
+    output = std::copy(first1, last1, output);
+    return std::copy(first2, last2, output);
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class Compare>
+bool includes(RandomAccessIterator1 first1, RandomAccessIterator1 last1,
+              RandomAccessIterator2 first2, RandomAccessIterator2 last2,
+              Compare comp) {
+    if (last2 - first2 > last1 - first1) {
+        return false;
+    }
+    for (; first2 != last2; ++first2, ++first1) {
+        first1 = gallop::lower_bound(first1, last1, *first2, comp);
+        if (first1 == last1 or comp(*first2, *first1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator, class Compare>
+OutputIterator set_intersection(RandomAccessIterator1 first1,
+                                RandomAccessIterator1 last1,
+                                RandomAccessIterator2 first2,
+                                RandomAccessIterator2 last2,
+                                OutputIterator output, Compare comp) {
+    while (first1 != last1 and first2 != last2) {
+        if (comp(*first1, *first2)) {
+            first1 = gallop::lower_bound(first1 + 1, last1, *first2,
+                                         comp);
+        } else if (comp(*first2, *first1)) {
+            first2 = gallop::lower_bound(first2 + 1, last2, *first1,
+                                         comp);
+        } else {
+            *output = *first1;
+            ++output;
+            ++first1;
+            ++first2;
+        }
+    }
+    return output;
+}
+
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class OutputIterator, class Compare>
+OutputIterator set_difference(RandomAccessIterator1 first1,
+                              RandomAccessIterator1 last1,
+                              RandomAccessIterator2 first2,
+                              RandomAccessIterator2 last2,
+                              OutputIterator output, Compare comp) {
+    while (first1 != last1 and first2 != last2) {
+        if (comp(*first1, *first2)) {
+            RandomAccessIterator1 run =
+                gallop::lower_bound(first1 + 1, last1, *first2, comp);
+            output = std::copy(first1, run, output);
+            first1 = run;
+        } else if (comp(*first2, *first1)) {
+            first2 = gallop::lower_bound(first2 + 1, last2, *first1,
+                                         comp);
+        } else {
+            ++first1;
+            ++first2;
+        }
+    }
+    return std::copy(first1, last1, output);
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef HEADER_GUARD_LINES_C
+#define HEADER_GUARD_LINES_C
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include "iterator-lines.hh"
+
+namespace prelude {
+
+inline StaticLineIterator::StaticLineIterator(const char* first,
+                                              const char* last,
+                                              char delimiter)
+    : cursor(first)
+    , limit(last)
+    , delimiter_position(NULL)
+    , delimiter(delimiter)
+    , has_current(false)
+    , fd(-1)
+    , eof(true)
+    , buffer_size(0)
+    , active(0) {
+    find_delimiter();
+    advance();
+}
+
+inline StaticLineIterator::StaticLineIterator(int fd, char delimiter,
+                                              size_t buffer_size)
+    : cursor(NULL)
+    , limit(NULL)
+    , delimiter_position(NULL)
+    , delimiter(delimiter)
+    , has_current(false)
+    , fd(fd)
+    , eof(false)
+    , buffer_size(buffer_size ? buffer_size : 1)
+    , active(0) {
+    advance();
+}
+
+inline StaticLineIterator::StaticLineIterator(
+    const StaticLineIterator& other)
+    : StaticIterator<StaticLineIterator, const StringView>(other) {
+    *this = other;
+}
+
+inline StaticLineIterator& StaticLineIterator::operator=(
+    const StaticLineIterator& other) {
+    if (this == &other) {
+        return *this;
+    }
+    delimiter = other.delimiter;
+    has_current = other.has_current;
+    fd = other.fd;
+    eof = other.eof;
+    buffer_size = other.buffer_size;
+    buffers[0] = other.buffers[0];
+    buffers[1] = other.buffers[1];
+    active = other.active;
+    cursor = rebase(other.cursor, other);
+    limit = rebase(other.limit, other);
+    delimiter_position = rebase(other.delimiter_position, other);
+    current.first = rebase(other.current.first, other);
+    current.last = rebase(other.current.last, other);
+    return *this;
+}
+
+inline const char* StaticLineIterator::rebase(
+    const char* p, const StaticLineIterator& other) const {
+    for (size_t i = 0; i < 2; ++i) {
+        const std::vector<char>& from = other.buffers[i];
+        if (not from.empty() and p >= &from[0] and
+            p <= &from[0] + from.size()) {
+            return &buffers[i][0] + (p - &from[0]);
+        }
+    }
+    // points into a caller's region, or nowhere.
+    return p;
+}
+
+inline void StaticLineIterator::find_delimiter() {
+    delimiter_position = NULL;
+    if (cursor != limit) {
+        delimiter_position = static_cast<const char*>(
+            memchr(cursor, delimiter, limit - cursor));
+    }
+}
+
+inline bool StaticLineIterator::needs_refill() const {
+    return delimiter_position == NULL and not eof;
+}
+
+// A partial line at the front of the active buffer is extended in
+// place, nothing points into that buffer before it.  Otherwise it is
+// copied to the front of the other buffer, so the views already handed
+// out from this one survive until the refill after.
+inline void StaticLineIterator::refill() {
+    size_t leftover = limit - cursor;
+    std::vector<char>* target = &buffers[active];
+    if (target->empty() or cursor != &(*target)[0]) {
+        active = 1 - active;
+        target = &buffers[active];
+        if (target->size() < std::max(buffer_size, 2 * leftover)) {
+            target->resize(std::max(buffer_size, 2 * leftover));
+        }
+        if (leftover != 0) {
+            memmove(&(*target)[0], cursor, leftover);
+        }
+    } else if (leftover == target->size()) {
+        target->resize(2 * leftover);
+    }
+    char* data = &(*target)[0];
+    ssize_t n;
+    do {
+        n = read(fd, data + leftover, target->size() - leftover);
+    } while (n < 0 and errno == EINTR);
+    if (n <= 0) {
+        // read errors end the input early, `errno` tells them apart.
+        eof = true;
+        n = 0;
+    }
+    cursor = data;
+    limit = data + leftover + n;
+    find_delimiter();
+}
+
+inline void StaticLineIterator::advance() {
+    while (needs_refill()) {
+        refill();
+    }
+    if (delimiter_position != NULL) {
+        current.first = cursor;
+        current.last = delimiter_position;
+        cursor = delimiter_position + 1;
+        has_current = true;
+        find_delimiter();
+    } else if (cursor != limit) {
+        // the last line has no delimiter.
+        current.first = cursor;
+        current.last = limit;
+        cursor = limit;
+        has_current = true;
+    } else {
+        has_current = false;
+    }
+}
+
+inline StaticLineIterator& StaticLineIterator::operator++() {
+    advance();
+    return *this;
+}
+
+inline StaticLineIterator::item_type* StaticLineIterator::next_chunk(
+    size_type& size) {
+    size = 0;
+    while (has_current and size < chunk_capacity) {
+        chunk[size++] = current;
+        // reading more moves on to the other buffer, stop the chunk
+        // so none of it gets overwritten by the refill after.
+        bool last = needs_refill();
+        advance();
+        if (last) {
+            break;
+        }
+    }
+    return size ? chunk : NULL;
+}
+
+inline bool StaticLineIterator::try_split(StaticLineIterator& back) {
+    if (fd >= 0 or limit - cursor < 2) {
+        return false;
+    }
+    const char* middle = cursor + (limit - cursor) / 2;
+    const char* split = static_cast<const char*>(
+        memchr(middle, delimiter, limit - middle));
+    if (split == NULL or split + 1 == limit) {
+        return false;
+    }
+    back = StaticLineIterator(split + 1, limit, delimiter);
+    limit = split + 1;
+    find_delimiter();
+    return true;
+}
+
+}
+
+#endif
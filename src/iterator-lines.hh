@@ -0,0 +1,108 @@
+#ifndef HEADER_GUARD_LINES_H
+#define HEADER_GUARD_LINES_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include "iterator.hh"
+
+namespace prelude {
+
+/// non-owning `[first, last)` slice of characters.
+struct StringView {
+    typedef const char* iterator;
+    typedef const char* const_iterator;
+    typedef char value_type;
+
+    const char* first;
+    const char* last;
+
+    const char* begin() const { return first; }
+    const char* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+    const char& operator[](size_t i) const { return first[i]; }
+    std::string str() const { return std::string(first, last); }
+};
+
+inline bool operator==(const StringView& a, const StringView& b) {
+    return a.size() == b.size() and
+           std::equal(a.first, a.last, b.first);
+}
+
+inline bool operator!=(const StringView& a, const StringView& b) {
+    return not(a == b);
+}
+
+/// splits a memory region or a file descriptor into lines (or any
+/// other `delimiter` separated records) without copying them: every
+/// item is a `StringView`, without its delimiter, into the region or
+/// into one of two large read buffers.  A view stays valid until the
+/// iterator moves past it, and a chunk until the next `next_chunk`.
+class StaticLineIterator
+    : public StaticIterator<StaticLineIterator, const StringView> {
+public:
+    typedef size_t size_type;
+    typedef const StringView item_type;
+
+    StaticLineIterator(const char* first, const char* last,
+                       char delimiter = '\n');
+    /// reads `fd` until the end, `buffer_size` bytes at a time.  Does
+    /// not close it.
+    explicit StaticLineIterator(int fd, char delimiter = '\n',
+                                size_t buffer_size = 1 << 20);
+    // the views point into our own buffers, so copies move them over.
+    // Copies share the file descriptor; only one should keep reading.
+    StaticLineIterator(const StaticLineIterator& other);
+    StaticLineIterator& operator=(const StaticLineIterator& other);
+
+    StaticLineIterator& operator++();
+    item_type* get() const { return has_current ? &current : NULL; }
+    item_type* next_chunk(size_type& size);
+    /// splits a memory region at the first line past its middle.  File
+    /// descriptors can't be split.
+    bool try_split(StaticLineIterator& back);
+
+private:
+    void find_delimiter();
+    bool needs_refill() const;
+    void refill();
+    void advance();
+    const char* rebase(const char* p,
+                       const StaticLineIterator& other) const;
+
+    const char* cursor;
+    const char* limit;
+    // the next delimiter in `[cursor, limit)`, if there is one.
+    const char* delimiter_position;
+    char delimiter;
+    StringView current;
+    bool has_current;
+
+    int fd;
+    bool eof;
+    size_t buffer_size;
+    std::vector<char> buffers[2];
+    size_t active;
+
+    static const size_t chunk_capacity = 64;
+    StringView chunk[chunk_capacity];
+};
+
+/// `StaticLineIterator` behind the virtual `Iterator<T>` interface.
+struct LineIterator : public VirtualIterator<StaticLineIterator> {
+    LineIterator(const char* first, const char* last,
+                 char delimiter = '\n')
+        : VirtualIterator<StaticLineIterator>(
+              StaticLineIterator(first, last, delimiter)) {}
+    explicit LineIterator(int fd, char delimiter = '\n',
+                          size_t buffer_size = 1 << 20)
+        : VirtualIterator<StaticLineIterator>(
+              StaticLineIterator(fd, delimiter, buffer_size)) {}
+};
+
+}
+
+#include "iterator-lines.cc"
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef HEADER_GUARD_MMAP_C
+#define HEADER_GUARD_MMAP_C
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "iterator-mmap.hh"
+
+namespace prelude {
+
+template <class T>
+MappedArray<T>::MappedArray()
+    : opened(false), mapping(NULL), bytes(0), data(NULL), length(0) {}
+
+template <class T>
+MappedArray<T>::MappedArray(const char* path)
+    : opened(false), mapping(NULL), bytes(0), data(NULL), length(0) {
+    open(path);
+}
+
+template <class T>
+MappedArray<T>::~MappedArray() {
+    close();
+}
+
+template <class T>
+bool MappedArray<T>::open(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    // `mmap` refuses empty mappings, and empty files need none.
+    if (st.st_size != 0) {
+        void* m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        mapping = m;
+        bytes = st.st_size;
+        data = static_cast<const T*>(mapping);
+        length = bytes / sizeof(T);
+    }
+    ::close(fd);
+    opened = true;
+    return true;
+}
+
+template <class T>
+void MappedArray<T>::close() {
+    if (mapping != NULL) {
+        munmap(mapping, bytes);
+    }
+    opened = false;
+    mapping = NULL;
+    bytes = 0;
+    data = NULL;
+    length = 0;
+}
+
+template <class T>
+bool MappedArray<T>::advise(Access access) const {
+    if (mapping == NULL) {
+        return opened;
+    }
+    int advice = MADV_NORMAL;
+    switch (access) {
+    case normal:
+        advice = MADV_NORMAL;
+        break;
+    case sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case random:
+        advice = MADV_RANDOM;
+        break;
+    case will_need:
+        advice = MADV_WILLNEED;
+        break;
+    }
+    return madvise(mapping, bytes, advice) == 0;
+}
+
+}
+
+#endif
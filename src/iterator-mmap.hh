@@ -0,0 +1,86 @@
+#ifndef HEADER_GUARD_MMAP_H
+#define HEADER_GUARD_MMAP_H
+
+#include <stddef.h>
+#include "iterator.hh"
+
+namespace prelude {
+
+// iterator-vector.hh includes iterator.hh, which includes this before
+// the definition when iterator-vector.hh is read first.
+template <class T, class Iter>
+struct StaticVectorIterator;
+
+/// read only view of a file of fixed size `T` records, mapped into
+/// memory so that algorithms can run over it without copying it.  A
+/// partial record at the end of the file is ignored.  `T` must be
+/// trivially copyable and laid out the same as in the file.
+template <class T>
+class MappedArray {
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+    typedef const T* iterator;
+    typedef const T* const_iterator;
+
+    /// how the mapping will be read, passed on to `madvise`.
+    enum Access { normal, sequential, random, will_need };
+
+    MappedArray();
+    explicit MappedArray(const char* path);
+    ~MappedArray();
+
+    /// maps `path`, unmapping any previous file.  On failure returns
+    /// false, leaves `errno` set and the array empty.
+    bool open(const char* path);
+    void close();
+    bool is_open() const { return opened; }
+
+    bool advise(Access access) const;
+
+    const T* begin() const { return data; }
+    const T* end() const { return data + length; }
+    size_type size() const { return length; }
+    bool empty() const { return length == 0; }
+    const T& operator[](size_type i) const { return data[i]; }
+
+private:
+    MappedArray(const MappedArray&);
+    MappedArray& operator=(const MappedArray&);
+
+    bool opened;
+    void* mapping;
+    size_t bytes;
+    const T* data;
+    size_type length;
+};
+
+/// `Iterator<const T>` over a `MappedArray<T>`, which has to outlive
+/// it.  Its sizes are exact and `next_chunk` returns the rest of the
+/// file at once.
+template <class T>
+struct MmapIterator
+    : public VirtualIterator<StaticVectorIterator<const T, const T*> > {
+    explicit MmapIterator(const MappedArray<T>& array)
+        : VirtualIterator<StaticVectorIterator<const T, const T*> >(
+              StaticVectorIterator<const T, const T*>(array.begin(),
+                                                      array.end())) {}
+};
+
+template <class T>
+MmapIterator<T> iterator(const MappedArray<T>& array) {
+    return MmapIterator<T>(array);
+}
+
+template <class T>
+StaticVectorIterator<const T, const T*> static_iterator(
+    const MappedArray<T>& array) {
+    return StaticVectorIterator<const T, const T*>(array.begin(),
+                                                   array.end());
+}
+
+}
+
+#include "iterator-mmap.cc"
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef HEADER_GUARD_ITERATOR_PREFETCH_C
+#define HEADER_GUARD_ITERATOR_PREFETCH_C
+
+#include "iterator-prefetch.hh"
+
+namespace prelude {
+
+template <class T, class Projection>
+PrefetchingIterator<T, Projection>::PrefetchingIterator(
+    Iterator<T>& source, size_type distance, Projection projection)
+    : source(&source)
+    , chunk(NULL)
+    , size(0)
+    , index(0)
+    , fetched(0)
+    , distance(distance)
+    , projection(projection) {
+    refill();
+}
+
+template <class T, class Projection>
+void PrefetchingIterator<T, Projection>::refill() {
+    chunk = source->next_chunk(size);
+    if (not chunk) {
+        size = 0;
+    }
+    index = 0;
+    fetched = 0;
+    fetch_until(distance);
+}
+
+template <class T, class Projection>
+void PrefetchingIterator<T, Projection>::fetch_until(size_type n) {
+    if (n > size) {
+        n = size;
+    }
+    for (; fetched < n; ++fetched) {
+        prefetch::fetch(projection(chunk[fetched]));
+    }
+}
+
+template <class T, class Projection>
+PrefetchingIterator<T, Projection>&
+PrefetchingIterator<T, Projection>::operator++() {
+    if (index == size) {
+        refill();
+    }
+    if (index < size) {
+        ++index;
+        fetch_until(index + distance);
+    }
+    return *this;
+}
+
+template <class T, class Projection>
+typename PrefetchingIterator<T, Projection>::item_type*
+PrefetchingIterator<T, Projection>::get() const {
+    return index < size ? chunk + index : source->get();
+}
+
+template <class T, class Projection>
+typename PrefetchingIterator<T, Projection>::size_type
+PrefetchingIterator<T, Projection>::skip(size_type n) {
+    size_type skipped = size - index;
+    if (skipped >= n) {
+        index += n;
+        fetch_until(index + distance);
+        return n;
+    }
+    // the rest of the chunk isn't enough: let `source` jump.
+    index = size;
+    return skipped + source->skip(n - skipped);
+}
+
+template <class T, class Projection>
+typename PrefetchingIterator<T, Projection>::item_type*
+PrefetchingIterator<T, Projection>::next_chunk(size_type& out) {
+    // pulling as soon as the last piece goes out would invalidate it.
+    if (index == size) {
+        refill();
+    }
+    out = size - index;
+    if (out == 0) {
+        return NULL;
+    }
+    if (distance != 0 and out > distance) {
+        out = distance;
+    }
+    item_type* first = chunk + index;
+    index += out;
+    fetch_until(index + distance);
+    return first;
+}
+
+}
+
+#endif
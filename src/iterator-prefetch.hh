@@ -0,0 +1,67 @@
+#ifndef HEADER_GUARD_ITERATOR_PREFETCH_H
+#define HEADER_GUARD_ITERATOR_PREFETCH_H
+
+#include <stddef.h>
+#include "iterator.hh"
+#include "prefetch.hh"
+
+namespace prelude {
+
+/// reads `source` a chunk at a time and fetches `projection(item)`
+/// for the item `distance` places ahead of the current one.  Fetches
+/// don't cross chunks, so this helps most over sources with long
+/// chunks like vectors and mapped arrays.  `next_chunk` hands out at
+/// most `distance` items at a time so the fetches stay ahead of a
+/// caller looping over them.
+///
+/// Doesn't own `source`, which has to outlive it.
+template <class T, class Projection = prefetch::element>
+struct PrefetchingIterator : public Iterator<T> {
+    typedef typename Iterator<T>::size_type size_type;
+    typedef typename Iterator<T>::item_type item_type;
+
+    PrefetchingIterator& operator++();
+    item_type* get() const;
+    size_type skip(size_type n);
+    item_type* next_chunk(size_type& size);
+
+    ~PrefetchingIterator() {}
+
+    PrefetchingIterator(Iterator<T>& source, size_type distance,
+                        Projection projection = Projection());
+
+private:
+    void refill();
+    void fetch_until(size_type n);
+
+    Iterator<T>* source;
+    // `[chunk, chunk + size)` came from `source`.  Once `index` reaches
+    // `size` the current item is `source`'s until we pull again.
+    item_type* chunk;
+    size_type size;
+    size_type index;
+    // every item before `fetched` has been prefetched.
+    size_type fetched;
+    size_type distance;
+    Projection projection;
+};
+
+template <class T>
+PrefetchingIterator<T> prefetching(Iterator<T>& source,
+                                   size_t distance) {
+    return PrefetchingIterator<T>(source, distance);
+}
+
+template <class T, class Projection>
+PrefetchingIterator<T, Projection> prefetching(Iterator<T>& source,
+                                               size_t distance,
+                                               Projection projection) {
+    return PrefetchingIterator<T, Projection>(source, distance,
+                                              projection);
+}
+
+}
+
+#include "iterator-prefetch.cc"
+
+#endif
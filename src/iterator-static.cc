@@ -0,0 +1,142 @@
+#ifndef HEADER_GUARD_ITERATOR_STATIC_C
+#define HEADER_GUARD_ITERATOR_STATIC_C
+
+#include "iterator-static.hh"
+
+namespace prelude {
+
+template <class Derived, class T>
+typename StaticIterator<Derived, T>::item_type&
+StaticIterator<Derived, T>::operator*() const {
+    return *derived().get();
+}
+
+template <class Derived, class T>
+bool StaticIterator<Derived, T>::min_size(size_type& out) const {
+    out = 0;
+    return true;
+}
+
+template <class Derived, class T>
+bool StaticIterator<Derived, T>::max_size(size_type&) const {
+    return false;
+}
+
+template <class Derived, class T>
+typename StaticIterator<Derived, T>::size_type
+StaticIterator<Derived, T>::skip(size_type n) {
+    size_type skipped = 0;
+    for (; skipped < n and derived().get(); ++skipped) {
+        ++derived();
+    }
+    return skipped;
+}
+
+template <class Derived, class T>
+typename StaticIterator<Derived, T>::size_type
+StaticIterator<Derived, T>::count() {
+    return derived().skip(static_cast<size_type>(-1));
+}
+
+template <class Derived, class T>
+typename StaticIterator<Derived, T>::item_type*
+StaticIterator<Derived, T>::last() {
+    size_type left;
+    if (derived().min_size(left) and left > 1) {
+        derived().skip(left - 1);
+    }
+    item_type* last = NULL;
+    for (item_type* t = derived().get(); t; t = (++derived()).get()) {
+        last = t;
+    }
+    return last;
+}
+
+template <class Derived, class T>
+typename StaticIterator<Derived, T>::item_type*
+StaticIterator<Derived, T>::nth(size_type n) {
+    derived().skip(n);
+    return derived().get();
+}
+
+template <class Derived, class T>
+typename StaticIterator<Derived, T>::item_type*
+StaticIterator<Derived, T>::next_chunk(size_type& size) {
+    item_type* t = derived().get();
+    size = t ? 1 : 0;
+    if (t) {
+        ++derived();
+    }
+    return t;
+}
+
+template <class Derived, class T>
+bool StaticIterator<Derived, T>::try_split(Derived&) {
+    return false;
+}
+
+template <class Static>
+VirtualIterator<Static>& VirtualIterator<Static>::operator++() {
+    ++iter;
+    return *this;
+}
+
+template <class Static>
+typename VirtualIterator<Static>::item_type*
+VirtualIterator<Static>::get() const {
+    return iter.get();
+}
+
+template <class Static>
+bool VirtualIterator<Static>::min_size(size_type& st) const {
+    return iter.min_size(st);
+}
+
+template <class Static>
+bool VirtualIterator<Static>::max_size(size_type& st) const {
+    return iter.max_size(st);
+}
+
+template <class Static>
+typename VirtualIterator<Static>::size_type
+VirtualIterator<Static>::skip(size_type n) {
+    return iter.skip(n);
+}
+
+template <class Static>
+typename VirtualIterator<Static>::size_type
+VirtualIterator<Static>::count() {
+    return iter.count();
+}
+
+template <class Static>
+typename VirtualIterator<Static>::item_type*
+VirtualIterator<Static>::last() {
+    return iter.last();
+}
+
+template <class Static>
+typename VirtualIterator<Static>::item_type*
+VirtualIterator<Static>::nth(size_type n) {
+    return iter.nth(n);
+}
+
+template <class Static>
+typename VirtualIterator<Static>::item_type*
+VirtualIterator<Static>::next_chunk(size_type& size) {
+    return iter.next_chunk(size);
+}
+
+template <class Static>
+VirtualIterator<Static>* VirtualIterator<Static>::split() {
+    VirtualIterator* back = new VirtualIterator(iter);
+    if (iter.try_split(back->iter)) {
+        return back;
+    }
+    delete back;
+    return NULL;
+}
+
+}
+
+#endif
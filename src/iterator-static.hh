@@ -0,0 +1,79 @@
+#ifndef HEADER_GUARD_ITERATOR_STATIC_H
+#define HEADER_GUARD_ITERATOR_STATIC_H
+
+#include <stddef.h>
+
+namespace prelude {
+
+template <class T>
+struct Iterator;
+
+/// the `Iterator<T>` protocol without virtual functions.  `Derived`
+/// provides `operator++` and `get`, and may shadow any of the other
+/// members with something faster.  Code that knows the concrete type
+/// calls it directly so everything can be inlined; wrap it in a
+/// `VirtualIterator` when the type has to be erased.
+template <class Derived, class T>
+struct StaticIterator {
+    typedef T item_type;
+    typedef size_t size_type;
+
+    item_type& operator*() const;
+
+    bool min_size(size_type&) const;
+    bool max_size(size_type&) const;
+    size_type skip(size_type n);
+    size_type count();
+    item_type* last();
+    item_type* nth(size_type n);
+    item_type* next_chunk(size_type& size);
+    /// moves the back half of the remaining items into `back`, or
+    /// returns false when they can't be divided.
+    bool try_split(Derived& back);
+
+protected:
+    Derived& derived() { return static_cast<Derived&>(*this); }
+    const Derived& derived() const {
+        return static_cast<const Derived&>(*this);
+    }
+};
+
+/// `Iterator<T>` that forwards every call to a `StaticIterator`.
+template <class Static>
+struct VirtualIterator : public Iterator<typename Static::item_type> {
+    typedef typename Iterator<typename Static::item_type>::size_type
+        size_type;
+    typedef typename Iterator<typename Static::item_type>::item_type
+        item_type;
+
+    VirtualIterator& operator++();
+    item_type* get() const;
+
+    bool min_size(size_type&) const;
+    bool max_size(size_type&) const;
+    size_type skip(size_type n);
+    size_type count();
+    item_type* last();
+    item_type* nth(size_type n);
+    item_type* next_chunk(size_type& size);
+    VirtualIterator* split();
+
+    ~VirtualIterator() {}
+
+    explicit VirtualIterator(const Static& iter)
+        : iter(iter) {}
+
+    Static iter;
+};
+
+template <class Static>
+VirtualIterator<Static> virtual_iterator(const Static& iter) {
+    return VirtualIterator<Static>(iter);
+}
+
+}
+
+#include "iterator.hh"
+#include "iterator-static.cc"
+
+#endif
@@ -10,14 +10,15 @@
 namespace prelude {
 
 template <class T, class Iter>
-VectorIterator<T, Iter>& VectorIterator<T, Iter>::operator++() {
+StaticVectorIterator<T, Iter>&
+StaticVectorIterator<T, Iter>::operator++() {
     ++iter;
     return *this;
 }
 
 template <class T, class Iter>
-typename VectorIterator<T, Iter>::item_type*
-VectorIterator<T, Iter>::get() const {
+typename StaticVectorIterator<T, Iter>::item_type*
+StaticVectorIterator<T, Iter>::get() const {
     if (iter >= end) {
         return nullptr;
     } else {
@@ -26,45 +27,52 @@ VectorIterator<T, Iter>::get() const {
 }
 
 template <class T, class Iter>
-bool VectorIterator<T, Iter>::min_size(size_type& st) const {
+bool StaticVectorIterator<T, Iter>::min_size(size_type& st) const {
     st = end - iter;
     return true;
 }
 
 template <class T, class Iter>
-bool VectorIterator<T, Iter>::max_size(size_type& st) const {
+bool StaticVectorIterator<T, Iter>::max_size(size_type& st) const {
     return min_size(st);
 }
 
 template <class T, class Iter>
-typename VectorIterator<T, Iter>::size_type
-VectorIterator<T, Iter>::count() {
-    VectorIterator<T, Iter>::size_type st = end - iter;
-    iter = end;
-    return st;
+typename StaticVectorIterator<T, Iter>::size_type
+StaticVectorIterator<T, Iter>::skip(size_type n) {
+    // `iter + n` may not be formed past `end`.
+    size_type left = end - iter;
+    if (n > left) {
+        n = left;
+    }
+    iter += n;
+    return n;
 }
 
 template <class T, class Iter>
-typename VectorIterator<T, Iter>::item_type*
-VectorIterator<T, Iter>::last() {
+typename StaticVectorIterator<T, Iter>::item_type*
+StaticVectorIterator<T, Iter>::next_chunk(size_type& size) {
     if (iter >= end) {
-        iter = end;
+        size = 0;
         return nullptr;
     } else {
+        size = end - iter;
+        item_type* first = &*iter;
         iter = end;
-        return &*(end - 1);
+        return first;
     }
 }
 
 template <class T, class Iter>
-typename VectorIterator<T, Iter>::item_type*
-VectorIterator<T, Iter>::nth(size_type n) {
-    if (iter + n >= end) {
-        iter = end;
-        return nullptr;
-    } else {
-        return &*(iter += n);
+bool StaticVectorIterator<T, Iter>::try_split(StaticVectorIterator& back) {
+    if (end - iter < 2) {
+        return false;
     }
+    Iter middle = iter + (end - iter) / 2;
+    back.iter = middle;
+    back.end = end;
+    end = middle;
+    return true;
 }
 }
 
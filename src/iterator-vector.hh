@@ -2,41 +2,47 @@
 #define HEADER_GUARD_VECTOR_H
 
 #include "iterator.hh"
+#include "iterator-static.hh"
 
 namespace prelude {
 
 template <class T, class Iter = typename std::vector<T>::iterator >
-struct VectorIterator : public Iterator<T> {
+struct StaticVectorIterator
+    : public StaticIterator<StaticVectorIterator<T, Iter>, T> {
     typedef Iter iterator;
-    typedef typename Iterator<T>::size_type size_type;
-    typedef typename Iterator<T>::item_type item_type;
+    typedef size_t size_type;
+    typedef T item_type;
 
-#if __cplusplus < 201103L
-#  define override
-#endif
+    StaticVectorIterator& operator++();
+    item_type* get() const;
 
-    VectorIterator& operator++() override;
-    item_type* get() const override;
+    bool min_size(size_type&) const;
+    bool max_size(size_type&) const;
+    size_type skip(size_type n);
+    item_type* next_chunk(size_type& size);
+    bool try_split(StaticVectorIterator& back);
 
-    bool min_size(size_type&) const override;
-    bool max_size(size_type&) const override;
-    size_type count() override;
-    item_type* last() override;
-    item_type* nth(size_type n) override;
+    StaticVectorIterator(iterator begin, iterator end)
+        : iter(begin), end(end) {}
 
-    ~VectorIterator() override {}
+private:
+    iterator iter;
+    iterator end;
+};
 
-#undef override
+/// `StaticVectorIterator` behind the virtual `Iterator<T>` interface.
+template <class T, class Iter = typename std::vector<T>::iterator >
+struct VectorIterator
+    : public VirtualIterator<StaticVectorIterator<T, Iter> > {
+    typedef Iter iterator;
 
 private:
     template <class U>
     friend VectorIterator<U> iterator(std::vector<U>&);
     // friend VectorIterator<const T> iterator(const std::vector<T>&);
     VectorIterator(iterator begin, iterator end)
-        : iter(begin), end(end) {}
-
-    iterator iter;
-    iterator end;
+        : VirtualIterator<StaticVectorIterator<T, Iter> >(
+              StaticVectorIterator<T, Iter>(begin, end)) {}
 };
 
 // template <class T>
@@ -48,6 +54,11 @@ VectorIterator<T> iterator(std::vector<T>& vector) {
     return VectorIterator<T>(vector.begin(), vector.end());
 }
 
+template <class T>
+StaticVectorIterator<T> static_iterator(std::vector<T>& vector) {
+    return StaticVectorIterator<T>(vector.begin(), vector.end());
+}
+
 // template <class T>
 // ConstVectorIterator<const T> iterator(const std::vector<T>& vector) {
 //     return ConstVectorIterator<const T>(vector.begin(), vector.end());
@@ -22,34 +22,58 @@ bool Iterator<T>::max_size(size_type&) const {
 }
 
 template <class T>
-typename Iterator<T>::size_type Iterator<T>::count() {
-    Iterator<T>::size_type count = 0;
-    for (; this->get(); ++count) {
+typename Iterator<T>::size_type Iterator<T>::skip(
+    Iterator<T>::size_type n) {
+    Iterator<T>::size_type skipped = 0;
+    for (; skipped < n and this->get(); ++skipped) {
         ++*this;
     }
-    return count;
+    return skipped;
+}
+
+template <class T>
+typename Iterator<T>::size_type Iterator<T>::count() {
+    return this->skip(static_cast<Iterator<T>::size_type>(-1));
 }
 
 template <class T>
 typename Iterator<T>::item_type* Iterator<T>::last() {
-    Iterator<T>::item_type* t = this->get();
-    while (t) {
-        t = (++*this).get();
+    // everything before the last of the items we know are left can
+    // be skipped; the rest has to be walked.
+    Iterator<T>::size_type left;
+    if (this->min_size(left) and left > 1) {
+        this->skip(left - 1);
     }
-    return t;
+    Iterator<T>::item_type* last = NULL;
+    for (Iterator<T>::item_type* t = this->get(); t;
+         t = (++*this).get()) {
+        last = t;
+    }
+    return last;
 }
 
 template <class T>
 typename Iterator<T>::item_type* Iterator<T>::nth(Iterator<T>::size_type n) {
-    for (; this->get(); ++*this) {
-        if (n == 0) {
-            return this->get();
-        }
-        --n;
-    }
+    this->skip(n);
+    return this->get();
+}
+
+template <class T>
+Iterator<T>* Iterator<T>::split() {
     return NULL;
 }
 
+template <class T>
+typename Iterator<T>::item_type* Iterator<T>::next_chunk(
+    Iterator<T>::size_type& size) {
+    Iterator<T>::item_type* t = this->get();
+    size = t ? 1 : 0;
+    if (t) {
+        ++*this;
+    }
+    return t;
+}
+
 }
 
 #endif
@@ -2,10 +2,18 @@
 #define HEADER_GUARD_ITERATOR_H
 
 #include <string.h>
+#include <iterator>
 #include <vector>
+#include "simd.hh"
 
 namespace prelude {
 
+#if __cplusplus >= 201103L
+// argument dependent lookup finds the standard versions for standard
+// containers anyway, so overloads of our own would be ambiguous.
+using ::std::begin;
+using ::std::end;
+#else
 /// implementation of the c++11 standard required `std::begin` and
 /// `std::end` functions.  c++98 compliant!  This is better than 
 template <class Container>
@@ -18,6 +26,26 @@ typename Container::const_iterator begin(const Container& container) {
     return container.begin();
 }
 
+template <class Container>
+typename Container::iterator end(Container& container) {
+    return container.end();
+}
+
+template <class Container>
+typename Container::const_iterator end(const Container& container) {
+    return container.end();
+}
+
+template <class T, size_t N>
+T* begin(T(&arr)[N]) {
+    return arr;
+}
+
+template <class T, size_t N>
+const T* begin(const T(&arr)[N]) {
+    return arr;
+}
+
 template <class T, size_t N>
 T* end(T(&arr)[N]) {
     return arr + N;
@@ -27,28 +55,29 @@ template <class T, size_t N>
 const T* end(const T(&arr)[N]) {
     return arr + N;
 }
+#endif
 
+/// the terminating zero (or null) of `arr`.  Integer and pointer
+/// arrays are scanned a vector at a time.
 template <class T>
 T* end_null(T* arr) {
-    for (; *arr != 0; ++arr) {
-    }
-    return arr;
+    return const_cast<T*>(simd::find_zero(static_cast<const T*>(arr)));
 }
 
 template <class T>
 const T* end_null(const T* arr) {
-    for (; *arr == 0; ++arr) {
-    }
-    return arr;
+    return simd::find_zero(arr);
 }
 
+// taking a reference keeps arrays from decaying to match these, which
+// would be ambiguous with the array versions.
 template <class T>
-T* begin(T* arr) {
+T* begin(T* const& arr) {
     return arr;
 }
 
 template <class T>
-const T* begin(const T* arr) {
+const T* begin(const T* const& arr) {
     return arr;
 }
 
@@ -95,15 +124,42 @@ struct Iterator {
 
     virtual bool min_size(size_type&) const;
     virtual bool max_size(size_type&) const;
+
+    /// moves past the next `n` items, or to the end when there are
+    /// fewer, and returns how many it moved past.  By default this
+    /// steps one item at a time; sources that can jump (indexed,
+    /// chunked or compressed ones) should override it.  `count`,
+    /// `nth` and `last` are built on it.
+    virtual size_type skip(size_type n);
+    /// moves past every item and returns how many there were.
     virtual size_type count();
+    /// moves past every item and returns the last one, or `NULL`.
     virtual item_type* last();
+    /// moves to the item `n` places on, and returns it or `NULL`.
     virtual item_type* nth(size_type n);
 
+    /// moves past the next `size` items, which are contiguous, and
+    /// returns the first of them, or `NULL` at the end.  This lets a
+    /// caller run a plain loop over each chunk instead of making two
+    /// virtual calls per item.  By default chunks are one item long,
+    /// which needs items to stay put once the iterator moves past
+    /// them; iterators that reuse storage must override this.
+    virtual item_type* next_chunk(size_type& size);
+
+    /// hands the back half of the remaining items to a new iterator,
+    /// which the caller deletes, and keeps the front half.  Returns
+    /// `NULL` when the items can't be divided, which is the default.
+    virtual Iterator* split();
+
     virtual ~Iterator() {}
 };
 
 }
+#include "iterator-static.hh"
 #include "iterator-vector.hh"
+#include "iterator-mmap.hh"
+#include "iterator-lines.hh"
+#include "iterator-prefetch.hh"
 #include "iterator.cc"
 
 #endif
@@ -2,7 +2,9 @@
 #define HEADER_GUARD_METAPROGRAMMING_H
 
 #include "type_traits.hh"
+#include <iterator>
 #include <stddef.h>
+#include <vector>
 
 namespace prelude {
 
@@ -15,13 +17,81 @@ struct iterator_type_of<T*> : type_declaration<T*> {};
 template <class T>
 struct iterator_type_of<const T*> : type_declaration<const T*> {};
 
+template <class Type>
+struct always_void {
+    typedef void type;
+};
+
+// Types without iterators get no `type` at all, so overloads for
+// containers drop out for them instead of failing to compile.
+template <class T, class Enable = void>
+struct member_iterator {};
+
 template <class T>
-struct iterator_type_of : type_declaration<typename T::iterator> {};
+struct member_iterator<T, typename always_void<typename T::iterator>::type>
+    : type_declaration<typename T::iterator> {};
+
+template <class T, class Enable = void>
+struct member_const_iterator {};
 
 template <class T>
-struct iterator_type_of<const T>
+struct member_const_iterator<
+    T, typename always_void<typename T::const_iterator>::type>
     : type_declaration<typename T::const_iterator> {};
 
+template <class T>
+struct iterator_type_of : member_iterator<T> {};
+
+template <class T>
+struct iterator_type_of<const T> : member_const_iterator<T> {};
+
+/// true when `Iterator` walks elements that are laid out
+/// contiguously in memory (raw pointers and `std::vector`'s
+/// iterators), so that `&*first` can be treated as an array.
+template <class Iterator, class Value>
+struct is_contiguous_iterator_impl
+    : integral_constant<
+          bool,
+          not is_same<Value, bool>::value and
+              (is_same<Iterator,
+                       typename std::vector<Value>::iterator>::value or
+               is_same<Iterator, typename std::vector<
+                                     Value>::const_iterator>::value)> {
+};
+
+template <class Iterator>
+struct is_contiguous_iterator_impl<Iterator, void> : false_type {};
+
+template <class Iterator>
+struct is_contiguous_iterator
+    : is_contiguous_iterator_impl<
+          Iterator,
+          typename std::iterator_traits<Iterator>::value_type> {};
+
+template <class T>
+struct is_contiguous_iterator<T*> : true_type {};
+
+template <class T>
+struct is_contiguous_iterator<const T*> : true_type {};
+
+/// true when `Container` can `reserve(size_type)` ahead of time, like
+/// `std::vector` and `std::string`.
+template <class Container>
+struct has_reserve_impl {
+    template <class U, void (U::*)(typename U::size_type)>
+    struct check;
+    template <class U>
+    static char test(check<U, &U::reserve>*);
+    template <class U>
+    static long test(...);
+
+    static const bool value = sizeof(test<Container>(0)) == 1;
+};
+
+template <class Container>
+struct has_reserve
+    : integral_constant<bool, has_reserve_impl<Container>::value> {};
+
 template <bool cond, class True, class False>
 struct static_type_if;
 
@@ -0,0 +1,463 @@
+#ifndef HEADER_GUARD_PARALLEL_H
+#define HEADER_GUARD_PARALLEL_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <unistd.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include "iterator.hh"
+
+namespace prelude {
+namespace parallel {
+
+inline size_t thread_count() {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? static_cast<size_t>(n) : 1;
+}
+
+template <class Task>
+struct Worker {
+    Task* task;
+    size_t* next;
+    size_t n;
+
+    static void* run(void* arg) {
+        Worker* self = static_cast<Worker*>(arg);
+        size_t i;
+        while ((i = __sync_fetch_and_add(self->next, 1)) < self->n) {
+            (*self->task)(i);
+        }
+        return NULL;
+    }
+};
+
+/// calls `task(i)` for every `i` in `[0, n)` on up to `threads`
+/// threads, the calling one included.  Indices are handed out one at
+/// a time so uneven tasks still balance.  `task` must not throw.
+template <class Task>
+void for_each_index(size_t n, Task& task,
+                    size_t threads = thread_count()) {
+    if (threads > n) {
+        threads = n;
+    }
+    size_t next = 0;
+    Worker<Task> worker = {&task, &next, n};
+    std::vector<pthread_t> ids(threads > 1 ? threads - 1 : 0);
+    size_t started = 0;
+    for (; started < ids.size(); ++started) {
+        // if we can't get more threads, make do with what we have.
+        if (pthread_create(&ids[started], NULL, &Worker<Task>::run,
+                           &worker) != 0) {
+            break;
+        }
+    }
+    Worker<Task>::run(&worker);
+    for (size_t i = 0; i < started; ++i) {
+        pthread_join(ids[i], NULL);
+    }
+}
+
+template <class T>
+#if __cplusplus >= 201103L
+T&& move_if_possible(T& t) {
+    return static_cast<T&&>(t);
+}
+#else
+T& move_if_possible(T& t) {
+    return t;
+}
+#endif
+
+// Sample sort: splitters drawn from a sorted sample cut the input into
+// buckets, every chunk of the input is scattered into its buckets in
+// parallel and then the buckets are sorted in parallel.
+template <class RandomAccessIterator, class Compare>
+struct SampleSort {
+    typedef typename std::iterator_traits<
+        RandomAccessIterator>::value_type value_type;
+
+    RandomAccessIterator first;
+    size_t n;
+    size_t chunks;
+    size_t buckets;
+    Compare comp;
+    std::vector<value_type> buffer;
+    std::vector<value_type> splitters;
+    // `positions[chunk * buckets + bucket]`: first a count, then where
+    // the chunk writes its next element of that bucket.
+    std::vector<size_t> positions;
+    std::vector<size_t> bucket_begin;
+
+    SampleSort(RandomAccessIterator first, RandomAccessIterator last,
+               Compare comp, size_t threads)
+        : first(first)
+        , n(last - first)
+        , chunks(threads)
+        , buckets(threads * 4)
+        , comp(comp)
+        , buffer(first, last)
+        , positions(chunks * buckets, 0)
+        , bucket_begin(buckets + 1, 0) {}
+
+    size_t chunk_begin(size_t chunk) const { return n * chunk / chunks; }
+
+    size_t bucket_of(const value_type& value) const {
+        return std::upper_bound(splitters.begin(), splitters.end(),
+                                value, comp) -
+               splitters.begin();
+    }
+
+    void choose_splitters() {
+        const size_t oversample = 16;
+        std::vector<value_type> samples;
+        samples.reserve(buckets * oversample);
+        for (size_t i = 0; i < buckets * oversample; ++i) {
+            samples.push_back(buffer[i * n / (buckets * oversample)]);
+        }
+        std::sort(samples.begin(), samples.end(), comp);
+        splitters.reserve(buckets - 1);
+        for (size_t b = 1; b < buckets; ++b) {
+            splitters.push_back(samples[b * oversample]);
+        }
+    }
+
+    void count(size_t chunk) {
+        size_t* counts = &positions[chunk * buckets];
+        for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1);
+             ++i) {
+            ++counts[bucket_of(buffer[i])];
+        }
+    }
+
+    void prefix_sums() {
+        size_t position = 0;
+        for (size_t b = 0; b < buckets; ++b) {
+            bucket_begin[b] = position;
+            for (size_t c = 0; c < chunks; ++c) {
+                size_t count = positions[c * buckets + b];
+                positions[c * buckets + b] = position;
+                position += count;
+            }
+        }
+        bucket_begin[buckets] = position;
+    }
+
+    void scatter(size_t chunk) {
+        size_t* next = &positions[chunk * buckets];
+        for (size_t i = chunk_begin(chunk); i < chunk_begin(chunk + 1);
+             ++i) {
+            first[next[bucket_of(buffer[i])]++] =
+                move_if_possible(buffer[i]);
+        }
+    }
+
+    void sort_bucket(size_t bucket) {
+        std::sort(first + bucket_begin[bucket],
+                  first + bucket_begin[bucket + 1], comp);
+    }
+
+    template <void (SampleSort::*Phase)(size_t)>
+    struct Task {
+        SampleSort* self;
+        void operator()(size_t i) { (self->*Phase)(i); }
+    };
+
+    void run() {
+        choose_splitters();
+        Task<&SampleSort::count> counting = {this};
+        for_each_index(chunks, counting, chunks);
+        prefix_sums();
+        Task<&SampleSort::scatter> scattering = {this};
+        for_each_index(chunks, scattering, chunks);
+        Task<&SampleSort::sort_bucket> sorting = {this};
+        for_each_index(buckets, sorting, chunks);
+    }
+};
+
+/// `std::sort` spread over `threads` threads.  Needs room for a copy
+/// of the range and falls back to `std::sort` for small inputs.
+template <class RandomAccessIterator, class Compare>
+void sort(RandomAccessIterator first, RandomAccessIterator last,
+          Compare comp, size_t threads = thread_count()) {
+    const size_t min_parallel_size = 1 << 15;
+    if (threads <= 1 or
+        static_cast<size_t>(last - first) < min_parallel_size) {
+        return std::sort(first, last, comp);
+    }
+    SampleSort<RandomAccessIterator, Compare> sorter(first, last, comp,
+                                                     threads);
+    sorter.run();
+}
+
+/// how many of the first `k` elements of the stable merge of
+/// `[a, a + n)` and `[b, b + m)` come from `a`.  Equal elements are
+/// taken from `a` first.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class Compare>
+size_t co_rank(size_t k, RandomAccessIterator1 a, size_t n,
+               RandomAccessIterator2 b, size_t m, Compare comp) {
+    size_t lo = k > m ? k - m : 0;
+    size_t hi = k < n ? k : n;
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (not comp(b[k - i - 1], a[i])) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+// Merge path: the output is cut into equal segments and the co-rank of
+// each cut says where the inputs split, so the segments can be merged
+// independently.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class RandomAccessIterator3, class Compare>
+struct Merge {
+    RandomAccessIterator1 first1;
+    size_t n1;
+    RandomAccessIterator2 first2;
+    size_t n2;
+    RandomAccessIterator3 output;
+    size_t segments;
+    Compare comp;
+
+    void operator()(size_t segment) {
+        size_t begin = (n1 + n2) * segment / segments;
+        size_t end = (n1 + n2) * (segment + 1) / segments;
+        size_t i = co_rank(begin, first1, n1, first2, n2, comp);
+        size_t i_end = co_rank(end, first1, n1, first2, n2, comp);
+        std::merge(first1 + i, first1 + i_end, first2 + (begin - i),
+                   first2 + (end - i_end), output + begin, comp);
+    }
+};
+
+/// `std::merge` spread over `threads` threads.  The result is the same
+/// as the sequential merge, equal elements included.  Falls back to
+/// `std::merge` for small inputs.
+template <class RandomAccessIterator1, class RandomAccessIterator2,
+          class RandomAccessIterator3, class Compare>
+RandomAccessIterator3 merge(RandomAccessIterator1 first1,
+                            RandomAccessIterator1 last1,
+                            RandomAccessIterator2 first2,
+                            RandomAccessIterator2 last2,
+                            RandomAccessIterator3 output, Compare comp,
+                            size_t threads = thread_count()) {
+    const size_t min_parallel_size = 1 << 15;
+    size_t n1 = last1 - first1;
+    size_t n2 = last2 - first2;
+    if (threads <= 1 or n1 + n2 < min_parallel_size) {
+        return std::merge(first1, last1, first2, last2, output, comp);
+    }
+    // a few segments per thread to even out the memory bandwidth.
+    Merge<RandomAccessIterator1, RandomAccessIterator2,
+          RandomAccessIterator3, Compare>
+        merging = {first1, n1, first2, n2, output, threads * 4, comp};
+    for_each_index(merging.segments, merging, threads);
+    return output + (n1 + n2);
+}
+
+/// `std::inplace_merge` spread over `threads` threads.  Needs room for
+/// a copy of the range.
+template <class RandomAccessIterator, class Compare>
+void inplace_merge(RandomAccessIterator first,
+                   RandomAccessIterator middle,
+                   RandomAccessIterator last, Compare comp,
+                   size_t threads = thread_count()) {
+    const size_t min_parallel_size = 1 << 15;
+    if (threads <= 1 or
+        static_cast<size_t>(last - first) < min_parallel_size) {
+        return std::inplace_merge(first, middle, last, comp);
+    }
+    typedef typename std::iterator_traits<
+        RandomAccessIterator>::value_type value_type;
+    std::vector<value_type> buffer(first, last);
+    parallel::merge(buffer.begin(), buffer.begin() + (middle - first),
+                    buffer.begin() + (middle - first), buffer.end(), first,
+                    comp, threads);
+}
+
+// Visits every item of an `Iterator<T>` from several threads.  The
+// iterator is split into pieces that are drained independently; when
+// it can't be split at all the calling thread reads ahead and hands
+// out batches of items instead, copying those the iterator would
+// overwrite.  `Visit` is called as `visit(worker, item)` with the
+// index of the piece or batch slice.
+template <class T, class Visit>
+struct IteratorVisitor {
+    typedef typename Iterator<T>::size_type size_type;
+
+    Visit& visit;
+    std::vector<Iterator<T>*> pieces;
+    std::vector<T*> batch;
+    std::vector<T> copies;
+    size_t slices;
+
+    explicit IteratorVisitor(Visit& visit)
+        : visit(visit)
+        , slices(0) {}
+
+    ~IteratorVisitor() {
+        // the first piece is the caller's.
+        for (size_t i = 1; i < pieces.size(); ++i) {
+            delete pieces[i];
+        }
+    }
+
+    // Every round halves each piece once, so the pieces stay about the
+    // same size instead of shrinking geometrically.
+    void split(Iterator<T>& it, size_t target) {
+        pieces.push_back(&it);
+        for (bool progress = true; progress and pieces.size() < target;) {
+            progress = false;
+            const size_t round = pieces.size();
+            for (size_t i = 0; i < round and pieces.size() < target; ++i) {
+                Iterator<T>* back = pieces[i]->split();
+                if (back) {
+                    pieces.push_back(back);
+                    progress = true;
+                }
+            }
+        }
+    }
+
+    void drain(size_t piece) {
+        size_type size;
+        for (T* chunk = pieces[piece]->next_chunk(size); chunk;
+             chunk = pieces[piece]->next_chunk(size)) {
+            for (size_type i = 0; i < size; ++i) {
+                visit(piece, chunk[i]);
+            }
+        }
+    }
+
+    void visit_slice(size_t slice) {
+        size_t first = batch.size() * slice / slices;
+        size_t last = batch.size() * (slice + 1) / slices;
+        for (size_t i = first; i < last; ++i) {
+            visit(slice, *batch[i]);
+        }
+    }
+
+    template <void (IteratorVisitor::*Phase)(size_t)>
+    struct Task {
+        IteratorVisitor* self;
+        void operator()(size_t i) { (self->*Phase)(i); }
+    };
+
+    void flush(size_t threads) {
+        slices = threads;
+        Task<&IteratorVisitor::visit_slice> visiting = {this};
+        for_each_index(slices, visiting, threads);
+        batch.clear();
+        copies.clear();
+    }
+
+    // Items of single item chunks stay put once the iterator moves
+    // on (see `Iterator<T>::next_chunk`), so the batch points at them;
+    // a longer chunk is only valid until the next call, so its items
+    // are copied.  `copies` never grows past the capacity reserved up
+    // front, which keeps the pointers into it valid until the flush.
+    void buffered(Iterator<T>& it, size_t threads) {
+        const size_t batch_size = 1 << 14;
+        batch.reserve(batch_size);
+        copies.reserve(batch_size);
+        size_type size;
+        for (T* chunk = it.next_chunk(size); chunk;
+             chunk = it.next_chunk(size)) {
+            for (size_type i = 0; i < size; ++i) {
+                if (size == 1) {
+                    batch.push_back(chunk);
+                } else {
+                    copies.push_back(chunk[i]);
+                    batch.push_back(&copies.back());
+                }
+                if (batch.size() >= batch_size) {
+                    flush(threads);
+                }
+            }
+        }
+        if (not batch.empty()) {
+            flush(threads);
+        }
+    }
+
+    // how many different workers `visit` may be called with.
+    size_t workers(size_t threads) const {
+        if (pieces.size() > 1) {
+            return pieces.size();
+        }
+        return threads > 1 ? threads : 1;
+    }
+
+    void run(Iterator<T>& it, size_t threads) {
+        if (threads <= 1) {
+            drain(0);
+        } else if (pieces.size() > 1) {
+            Task<&IteratorVisitor::drain> draining = {this};
+            for_each_index(pieces.size(), draining, threads);
+        } else {
+            buffered(it, threads);
+        }
+    }
+};
+
+template <class Function>
+struct ForEachVisit {
+    Function function;
+    template <class T>
+    void operator()(size_t, T& item) {
+        function(item);
+    }
+};
+
+/// calls `function(item)` for every item of `it` on up to `threads`
+/// threads at once, in no particular order.  `function` must be safe
+/// to call concurrently.
+template <class T, class Function>
+void for_each(Iterator<T>& it, Function function,
+              size_t threads = thread_count()) {
+    ForEachVisit<Function> visit = {function};
+    IteratorVisitor<T, ForEachVisit<Function> > visitor(visit);
+    visitor.split(it, threads > 1 ? threads * 4 : 1);
+    visitor.run(it, threads);
+}
+
+template <class Predicate>
+struct CountIfVisit {
+    Predicate pred;
+    // one counter per worker, a cache line apart.
+    std::vector<size_t> counts;
+    template <class T>
+    void operator()(size_t worker, T& item) {
+        counts[worker * 8] += pred(item) ? 1 : 0;
+    }
+};
+
+/// the number of items of `it` satisfying `pred`, evaluated on up to
+/// `threads` threads at once.  `pred` must be safe to call
+/// concurrently, which rules out `adaptive::Predicate`: its copies
+/// share and update one set of statistics.
+template <class T, class Predicate>
+size_t count_if(Iterator<T>& it, Predicate pred,
+                size_t threads = thread_count()) {
+    CountIfVisit<Predicate> visit = {pred, std::vector<size_t>()};
+    IteratorVisitor<T, CountIfVisit<Predicate> > visitor(visit);
+    visitor.split(it, threads > 1 ? threads * 4 : 1);
+    visit.counts.resize(visitor.workers(threads) * 8);
+    visitor.run(it, threads);
+    size_t result = 0;
+    for (size_t i = 0; i < visit.counts.size(); i += 8) {
+        result += visit.counts[i];
+    }
+    return result;
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef HEADER_GUARD_PREFETCH_H
+#define HEADER_GUARD_PREFETCH_H
+
+#include <stddef.h>
+#include <iterator>
+#include "view.hh"
+
+namespace prelude {
+/// Software prefetching for walks the hardware can't predict, such as
+/// gathering through an index array or following a vector of pointers.
+/// The adapters look `distance` elements ahead of the caller and fetch
+/// whatever address the projection gives for that element, so its
+/// cache miss overlaps with the work on the elements before it.
+namespace prefetch {
+
+inline void fetch(const void* address) {
+#if defined(__GNUC__) or defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+/// projection fetching the element itself.
+struct element {
+    template <class T>
+    const T* operator()(const T& t) const {
+        return &t;
+    }
+};
+
+/// projection fetching what the element points to.
+struct pointee {
+    template <class T>
+    const T* operator()(const T* t) const {
+        return t;
+    }
+};
+
+/// `ForwardIterator` that fetches `projection(*ahead)` every time it
+/// moves, where `ahead` is `distance` elements further along.  It never
+/// reads at or past `last`.
+template <class ForwardIterator, class Projection = element>
+class Adapter {
+    ForwardIterator it;
+    ForwardIterator ahead;
+    ForwardIterator last;
+    Projection projection;
+
+    void step() {
+        prefetch::fetch(projection(*ahead));
+        ++ahead;
+    }
+
+public:
+    typedef typename std::iterator_traits<ForwardIterator>::value_type
+        value_type;
+    typedef typename std::iterator_traits<
+        ForwardIterator>::difference_type difference_type;
+    typedef typename std::iterator_traits<ForwardIterator>::pointer
+        pointer;
+    typedef typename std::iterator_traits<ForwardIterator>::reference
+        reference;
+    // `ahead` walks the range a second time.
+    typedef std::forward_iterator_tag iterator_category;
+
+    Adapter(ForwardIterator it, ForwardIterator last, size_t distance,
+            Projection projection)
+        : it(it)
+        , ahead(it)
+        , last(last)
+        , projection(projection) {
+        for (; distance != 0 and ahead != last; --distance) {
+            step();
+        }
+    }
+
+    reference operator*() const { return *it; }
+    Adapter& operator++() {
+        ++it;
+        if (ahead != last) {
+            step();
+        }
+        return *this;
+    }
+    Adapter operator++(int) {
+        Adapter old = *this;
+        ++*this;
+        return old;
+    }
+    bool operator==(const Adapter& other) const { return it == other.it; }
+    bool operator!=(const Adapter& other) const { return it != other.it; }
+};
+
+}
+
+/// `[first, last)` read through `prefetch::Adapter`, fetching each
+/// element `distance` steps before it is reached.  The range works
+/// with the container overloads; its `begin()` and `end()` with the
+/// iterator ones.
+template <class ForwardIterator, class Projection>
+view::Range<prefetch::Adapter<ForwardIterator, Projection> > prefetching(
+    ForwardIterator first, ForwardIterator last, size_t distance,
+    Projection projection) {
+    typedef prefetch::Adapter<ForwardIterator, Projection> Adapter;
+    return view::Range<Adapter>(
+        Adapter(first, last, distance, projection),
+        Adapter(last, last, 0, projection));
+}
+
+template <class ForwardIterator>
+view::Range<prefetch::Adapter<ForwardIterator> > prefetching(
+    ForwardIterator first, ForwardIterator last, size_t distance) {
+    return prefetching(first, last, distance, prefetch::element());
+}
+
+/// `container` with `projection(element)` fetched `distance` elements
+/// ahead, e.g. `prefetching(nodes, 16, prefetch::pointee())`.
+template <class Container, class Projection>
+view::Range<
+    prefetch::Adapter<typename Container::const_iterator, Projection> >
+prefetching(const Container& container, size_t distance,
+            Projection projection) {
+    return prefetching(container.begin(), container.end(), distance,
+                       projection);
+}
+
+template <class Container>
+view::Range<prefetch::Adapter<typename Container::const_iterator> >
+prefetching(const Container& container, size_t distance) {
+    return prefetching(container.begin(), container.end(), distance,
+                       prefetch::element());
+}
+
+}
+
+#endif
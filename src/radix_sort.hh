@@ -0,0 +1,213 @@
+#ifndef HEADER_GUARD_RADIX_SORT_H
+#define HEADER_GUARD_RADIX_SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include "iterator.hh"
+#include "metaprogramming.hh"
+#include "type_traits.hh"
+
+namespace prelude {
+namespace radix {
+
+/// types whose order can be read off their bits.  `long double` has
+/// padding and `bool` isn't worth it.
+template <class T>
+struct is_sortable
+    : integral_constant<bool, (is_integral<T>::value and
+                               not is_same<T, bool>::value) or
+                                  is_same<T, float>::value or
+                                  is_same<T, double>::value> {};
+
+template <size_t Size>
+struct unsigned_of_size;
+template <>
+struct unsigned_of_size<1> : type_declaration<uint8_t> {};
+template <>
+struct unsigned_of_size<2> : type_declaration<uint16_t> {};
+template <>
+struct unsigned_of_size<4> : type_declaration<uint32_t> {};
+template <>
+struct unsigned_of_size<8> : type_declaration<uint64_t> {};
+
+/// maps a key to an unsigned integer with the same ordering.
+template <class Key, bool Float = is_floating_point<Key>::value,
+          bool Signed = is_signed<Key>::value>
+struct ordered_bits {
+    typedef typename unsigned_of_size<sizeof(Key)>::type type;
+    static type get(Key key) { return static_cast<type>(key); }
+};
+
+// two's complement: flipping the sign bit puts negatives first.
+template <class Key>
+struct ordered_bits<Key, false, true> {
+    typedef typename unsigned_of_size<sizeof(Key)>::type type;
+    static type get(Key key) {
+        return static_cast<type>(static_cast<type>(key) ^
+                                 (type(1) << (sizeof(Key) * 8 - 1)));
+    }
+};
+
+// sign and magnitude: negatives get all their bits flipped so that
+// larger magnitudes sort first, positives only get the sign bit set.
+template <class Key>
+struct ordered_bits<Key, true, true> {
+    typedef typename unsigned_of_size<sizeof(Key)>::type type;
+    static type get(Key key) {
+        type bits;
+        memcpy(&bits, &key, sizeof(Key));
+        const type sign = type(1) << (sizeof(Key) * 8 - 1);
+        return bits ^ ((bits & sign) ? ~type(0) : sign);
+    }
+};
+
+template <class T>
+struct identity_key {
+    const T& operator()(const T& t) const { return t; }
+};
+
+template <class In, class Out, class KeyFunction, class Key>
+void scatter(In in, size_t n, Out out, size_t* offsets, size_t shift,
+             KeyFunction key, Key) {
+    for (size_t i = 0; i < n; ++i) {
+        size_t digit = (ordered_bits<Key>::get(key(in[i])) >> shift) &
+                       0xff;
+#if __cplusplus >= 201103L
+        out[offsets[digit]++] = std::move(in[i]);
+#else
+        out[offsets[digit]++] = in[i];
+#endif
+    }
+}
+
+// The trailing `Key` only exists to deduce the key type in C++98.
+template <class RandomAccessIterator, class KeyFunction, class Key>
+void sort_by(RandomAccessIterator first, RandomAccessIterator last,
+             KeyFunction key, Key) {
+    typedef typename ordered_bits<Key>::type bits_type;
+    const size_t digits = sizeof(bits_type);
+    const size_t n = last - first;
+
+    // histograms of every byte at once, so constant columns are known
+    // before any pass is made.
+    std::vector<size_t> counts(digits * 256, 0);
+    for (RandomAccessIterator it = first; it != last; ++it) {
+        bits_type bits = ordered_bits<Key>::get(key(*it));
+        for (size_t d = 0; d < digits; ++d) {
+            ++counts[d * 256 + ((bits >> (d * 8)) & 0xff)];
+        }
+    }
+
+    const bits_type first_bits = ordered_bits<Key>::get(key(*first));
+    std::vector<size_t> passes;
+    for (size_t d = 0; d < digits; ++d) {
+        if (counts[d * 256 + ((first_bits >> (d * 8)) & 0xff)] != n) {
+            passes.push_back(d);
+        }
+    }
+    if (passes.empty()) {
+        return;
+    }
+
+    // both copies start out equal, so pick the starting side that
+    // makes the last pass land back in `[first, last)`.
+    typedef typename std::iterator_traits<
+        RandomAccessIterator>::value_type value_type;
+    std::vector<value_type> buffer(first, last);
+    bool in_buffer = passes.size() % 2 == 1;
+    for (size_t p = 0; p < passes.size(); ++p) {
+        size_t* offsets = &counts[passes[p] * 256];
+        size_t sum = 0;
+        for (size_t i = 0; i < 256; ++i) {
+            size_t count = offsets[i];
+            offsets[i] = sum;
+            sum += count;
+        }
+        if (in_buffer) {
+            scatter(buffer.begin(), n, first, offsets, passes[p] * 8,
+                    key, Key());
+        } else {
+            scatter(first, n, buffer.begin(), offsets, passes[p] * 8,
+                    key, Key());
+        }
+        in_buffer = not in_buffer;
+    }
+}
+
+template <class RandomAccessIterator>
+void sort(RandomAccessIterator first, RandomAccessIterator last,
+          true_type) {
+    // below this the histograms cost more than they save.
+    const ptrdiff_t min_radix_size = 1024;
+    if (last - first < min_radix_size) {
+        return std::sort(first, last);
+    }
+    typedef typename std::iterator_traits<
+        RandomAccessIterator>::value_type value_type;
+    return sort_by(first, last, identity_key<value_type>(),
+                   value_type());
+}
+
+template <class RandomAccessIterator>
+void sort(RandomAccessIterator first, RandomAccessIterator last,
+          false_type) {
+    return std::sort(first, last);
+}
+
+/// `std::sort` that switches to radix sort for large ranges of
+/// integers and floating point numbers.
+template <class RandomAccessIterator>
+void sort(RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename std::iterator_traits<
+        RandomAccessIterator>::value_type value_type;
+    // qualified, or std::sort would be found for the tag argument.
+    return radix::sort(
+        first, last,
+        integral_constant<bool, is_sortable<value_type>::value>());
+}
+
+}
+
+/// stable LSD radix sort of integers or floats (negative zero sorts
+/// before zero, NaNs go to the end matching their sign bit).  Byte
+/// columns that are the same for every element are skipped.  Needs
+/// room for a copy of the range.
+template <class RandomAccessIterator>
+void radix_sort(RandomAccessIterator first, RandomAccessIterator last) {
+    typedef typename std::iterator_traits<
+        RandomAccessIterator>::value_type value_type;
+    if (first == last) {
+        return;
+    }
+    return radix::sort_by(first, last, radix::identity_key<value_type>(),
+                          value_type());
+}
+
+/// stable radix sort ordering elements by `key(element)`, which must
+/// return an integer or float.
+template <class RandomAccessIterator, class KeyFunction>
+void radix_sort_by(RandomAccessIterator first, RandomAccessIterator last,
+                   KeyFunction key) {
+    if (first == last) {
+        return;
+    }
+    return radix::sort_by(first, last, key, key(*first));
+}
+
+template <class Container>
+void radix_sort(Container& container) {
+    return radix_sort(container.begin(), container.end());
+}
+
+template <class Container, class KeyFunction>
+void radix_sort_by(Container& container, KeyFunction key) {
+    return radix_sort_by(container.begin(), container.end(), key);
+}
+
+}
+
+#endif
@@ -0,0 +1,1149 @@
+#ifndef HEADER_GUARD_SIMD_H
+#define HEADER_GUARD_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include "metaprogramming.hh"
+#include "type_traits.hh"
+
+// Define PRELUDE_NO_SIMD to force the scalar loops everywhere.
+#if !defined(PRELUDE_NO_SIMD) and                               \
+    (defined(__GNUC__) or defined(__clang__)) and               \
+    (defined(__x86_64__) or defined(__i386__)) and defined(__SSE2__)
+#define PRELUDE_SIMD_X86 1
+#include <immintrin.h>
+#define PRELUDE_TARGET_AVX2 __attribute__((target("avx2")))
+// the sentinel scans read whole aligned vectors around the terminator,
+// which is safe but outside the object as far as ASan knows.
+#define PRELUDE_NO_SANITIZE __attribute__((no_sanitize_address))
+#endif
+
+namespace prelude {
+namespace simd {
+
+/// element types the compare kernels understand.  `bool` is left out
+/// as its object representation isn't guaranteed to be 0 or 1.
+template <class T>
+struct is_vectorizable
+    : integral_constant<bool, is_arithmetic<T>::value and
+                                  not is_same<T, bool>::value and
+                                  (sizeof(T) == 1 or sizeof(T) == 2 or
+                                   sizeof(T) == 4 or sizeof(T) == 8) and
+                                  not(is_floating_point<T>::value and
+                                      sizeof(T) < 4)> {};
+
+#ifdef PRELUDE_SIMD_X86
+inline bool has_avx2() {
+    static const bool result = __builtin_cpu_supports("avx2");
+    return result;
+}
+
+inline __m128i invert(__m128i v) {
+    return _mm_xor_si128(v, _mm_set1_epi32(-1));
+}
+
+PRELUDE_TARGET_AVX2 inline __m256i invert(__m256i v) {
+    return _mm256_xor_si256(v, _mm256_set1_epi32(-1));
+}
+
+template <class T, size_t Size = sizeof(T),
+          bool Float = is_floating_point<T>::value>
+struct lanes;
+
+template <class T>
+struct lanes<T, 1, false> {
+    static __m128i eq(__m128i a, __m128i b) {
+        return _mm_cmpeq_epi8(a, b);
+    }
+    PRELUDE_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi8(a, b);
+    }
+    static __m128i gt(__m128i a, __m128i b) {
+        return _mm_cmpgt_epi8(a, b);
+    }
+    PRELUDE_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {
+        return _mm256_cmpgt_epi8(a, b);
+    }
+    static __m128i ne(__m128i a, __m128i b) {
+        return invert(eq(a, b));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ne(__m256i a, __m256i b) {
+        return invert(eq(a, b));
+    }
+    static __m128i ge(__m128i a, __m128i b) {
+        return invert(gt(b, a));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ge(__m256i a, __m256i b) {
+        return invert(gt(b, a));
+    }
+    static unsigned bits(__m128i v) {
+        return static_cast<unsigned>(_mm_movemask_epi8(v));
+    }
+    PRELUDE_TARGET_AVX2 static unsigned bits(__m256i v) {
+        return static_cast<unsigned>(_mm256_movemask_epi8(v));
+    }
+};
+
+template <class T>
+struct lanes<T, 2, false> {
+    static __m128i eq(__m128i a, __m128i b) {
+        return _mm_cmpeq_epi16(a, b);
+    }
+    PRELUDE_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi16(a, b);
+    }
+    static __m128i gt(__m128i a, __m128i b) {
+        return _mm_cmpgt_epi16(a, b);
+    }
+    PRELUDE_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {
+        return _mm256_cmpgt_epi16(a, b);
+    }
+    static __m128i ne(__m128i a, __m128i b) {
+        return invert(eq(a, b));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ne(__m256i a, __m256i b) {
+        return invert(eq(a, b));
+    }
+    static __m128i ge(__m128i a, __m128i b) {
+        return invert(gt(b, a));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ge(__m256i a, __m256i b) {
+        return invert(gt(b, a));
+    }
+    // narrow every lane to a byte first.
+    static unsigned bits(__m128i v) {
+        return static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_packs_epi16(v, _mm_setzero_si128())));
+    }
+    // packing works within each 128 bit half, leaving the two halves'
+    // bits 16 apart.
+    PRELUDE_TARGET_AVX2 static unsigned bits(__m256i v) {
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_packs_epi16(v, _mm256_setzero_si256())));
+        return (mask & 0xff) | ((mask >> 8) & 0xff00);
+    }
+};
+
+template <class T>
+struct lanes<T, 4, false> {
+    static __m128i eq(__m128i a, __m128i b) {
+        return _mm_cmpeq_epi32(a, b);
+    }
+    PRELUDE_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+    static __m128i gt(__m128i a, __m128i b) {
+        return _mm_cmpgt_epi32(a, b);
+    }
+    PRELUDE_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {
+        return _mm256_cmpgt_epi32(a, b);
+    }
+    static __m128i ne(__m128i a, __m128i b) {
+        return invert(eq(a, b));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ne(__m256i a, __m256i b) {
+        return invert(eq(a, b));
+    }
+    static __m128i ge(__m128i a, __m128i b) {
+        return invert(gt(b, a));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ge(__m256i a, __m256i b) {
+        return invert(gt(b, a));
+    }
+    static unsigned bits(__m128i v) {
+        return static_cast<unsigned>(
+            _mm_movemask_ps(_mm_castsi128_ps(v)));
+    }
+    PRELUDE_TARGET_AVX2 static unsigned bits(__m256i v) {
+        return static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(v)));
+    }
+};
+
+template <class T>
+struct lanes<T, 8, false> {
+    // sse2 has no 64 bit compare: both 32 bit halves have to match.
+    static __m128i eq(__m128i a, __m128i b) {
+        __m128i halves = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(
+            halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi64(a, b);
+    }
+    // nor a 64 bit greater than: the high halves decide unless they
+    // are equal, then the low halves compared unsigned do.
+    static __m128i gt(__m128i a, __m128i b) {
+        const __m128i flip = _mm_set1_epi32(-0x7fffffff - 1);
+        __m128i high = _mm_cmpgt_epi32(a, b);
+        __m128i low = _mm_cmpgt_epi32(_mm_xor_si128(a, flip),
+                                      _mm_xor_si128(b, flip));
+        __m128i result = _mm_or_si128(
+            high,
+            _mm_and_si128(_mm_cmpeq_epi32(a, b),
+                          _mm_shuffle_epi32(low, _MM_SHUFFLE(2, 2, 0, 0))));
+        return _mm_shuffle_epi32(result, _MM_SHUFFLE(3, 3, 1, 1));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {
+        return _mm256_cmpgt_epi64(a, b);
+    }
+    static __m128i ne(__m128i a, __m128i b) {
+        return invert(eq(a, b));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ne(__m256i a, __m256i b) {
+        return invert(eq(a, b));
+    }
+    static __m128i ge(__m128i a, __m128i b) {
+        return invert(gt(b, a));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ge(__m256i a, __m256i b) {
+        return invert(gt(b, a));
+    }
+    static unsigned bits(__m128i v) {
+        return static_cast<unsigned>(
+            _mm_movemask_pd(_mm_castsi128_pd(v)));
+    }
+    PRELUDE_TARGET_AVX2 static unsigned bits(__m256i v) {
+        return static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(v)));
+    }
+};
+
+template <class T>
+struct lanes<T, 4, true> {
+    static __m128i eq(__m128i a, __m128i b) {
+        return _mm_castps_si128(
+            _mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {
+        return _mm256_castps_si256(
+            _mm256_cmp_ps(_mm256_castsi256_ps(a),
+                          _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+    // only `!=` holds for NaN, so these can't be negations.
+    static __m128i gt(__m128i a, __m128i b) {
+        return _mm_castps_si128(
+            _mm_cmpgt_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {
+        return _mm256_castps_si256(
+            _mm256_cmp_ps(_mm256_castsi256_ps(a),
+                          _mm256_castsi256_ps(b), _CMP_GT_OQ));
+    }
+    static __m128i ge(__m128i a, __m128i b) {
+        return _mm_castps_si128(
+            _mm_cmpge_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ge(__m256i a, __m256i b) {
+        return _mm256_castps_si256(
+            _mm256_cmp_ps(_mm256_castsi256_ps(a),
+                          _mm256_castsi256_ps(b), _CMP_GE_OQ));
+    }
+    static __m128i ne(__m128i a, __m128i b) {
+        return _mm_castps_si128(
+            _mm_cmpneq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ne(__m256i a, __m256i b) {
+        return _mm256_castps_si256(
+            _mm256_cmp_ps(_mm256_castsi256_ps(a),
+                          _mm256_castsi256_ps(b), _CMP_NEQ_UQ));
+    }
+    static unsigned bits(__m128i v) {
+        return static_cast<unsigned>(
+            _mm_movemask_ps(_mm_castsi128_ps(v)));
+    }
+    PRELUDE_TARGET_AVX2 static unsigned bits(__m256i v) {
+        return static_cast<unsigned>(
+            _mm256_movemask_ps(_mm256_castsi256_ps(v)));
+    }
+};
+
+template <class T>
+struct lanes<T, 8, true> {
+    static __m128i eq(__m128i a, __m128i b) {
+        return _mm_castpd_si128(
+            _mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(
+            _mm256_cmp_pd(_mm256_castsi256_pd(a),
+                          _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+    static __m128i gt(__m128i a, __m128i b) {
+        return _mm_castpd_si128(
+            _mm_cmpgt_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(
+            _mm256_cmp_pd(_mm256_castsi256_pd(a),
+                          _mm256_castsi256_pd(b), _CMP_GT_OQ));
+    }
+    static __m128i ge(__m128i a, __m128i b) {
+        return _mm_castpd_si128(
+            _mm_cmpge_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ge(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(
+            _mm256_cmp_pd(_mm256_castsi256_pd(a),
+                          _mm256_castsi256_pd(b), _CMP_GE_OQ));
+    }
+    static __m128i ne(__m128i a, __m128i b) {
+        return _mm_castpd_si128(
+            _mm_cmpneq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i ne(__m256i a, __m256i b) {
+        return _mm256_castpd_si256(
+            _mm256_cmp_pd(_mm256_castsi256_pd(a),
+                          _mm256_castsi256_pd(b), _CMP_NEQ_UQ));
+    }
+    static unsigned bits(__m128i v) {
+        return static_cast<unsigned>(
+            _mm_movemask_pd(_mm_castsi128_pd(v)));
+    }
+    PRELUDE_TARGET_AVX2 static unsigned bits(__m256i v) {
+        return static_cast<unsigned>(
+            _mm256_movemask_pd(_mm256_castsi256_pd(v)));
+    }
+};
+
+template <class T>
+__m128i splat128(T val) {
+    T buffer[16 / sizeof(T)];
+    for (size_t i = 0; i < 16 / sizeof(T); ++i) {
+        buffer[i] = val;
+    }
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+}
+
+template <class T>
+PRELUDE_TARGET_AVX2 __m256i splat256(T val) {
+    T buffer[32 / sizeof(T)];
+    for (size_t i = 0; i < 32 / sizeof(T); ++i) {
+        buffer[i] = val;
+    }
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buffer));
+}
+
+inline __m128i load128(const void* ptr) {
+    return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+}
+
+PRELUDE_TARGET_AVX2 inline __m256i load256(const void* ptr) {
+    return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+}
+
+// Every matching lane sets `sizeof(T)` bits of the byte mask, so
+// positions and counts are recovered by dividing by the lane size.
+template <class T>
+size_t find_sse2(const T* first, size_t n, T val) {
+    const size_t width = 16 / sizeof(T);
+    const __m128i needle = splat128(val);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            lanes<T>::eq(load128(first + i), needle)));
+        if (mask) {
+            return i + __builtin_ctz(mask) / sizeof(T);
+        }
+    }
+    for (; i < n; ++i) {
+        if (first[i] == val) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <class T>
+PRELUDE_TARGET_AVX2 size_t find_avx2(const T* first, size_t n, T val) {
+    const size_t width = 32 / sizeof(T);
+    const __m256i needle = splat256(val);
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            lanes<T>::eq(load256(first + i), needle)));
+        if (mask) {
+            return i + __builtin_ctz(mask) / sizeof(T);
+        }
+    }
+    for (; i < n; ++i) {
+        if (first[i] == val) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <class T>
+size_t count_sse2(const T* first, size_t n, T val) {
+    const size_t width = 16 / sizeof(T);
+    const __m128i needle = splat128(val);
+    size_t bits = 0;
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        bits += __builtin_popcount(_mm_movemask_epi8(
+            lanes<T>::eq(load128(first + i), needle)));
+    }
+    size_t result = bits / sizeof(T);
+    for (; i < n; ++i) {
+        result += first[i] == val;
+    }
+    return result;
+}
+
+template <class T>
+PRELUDE_TARGET_AVX2 size_t count_avx2(const T* first, size_t n, T val) {
+    const size_t width = 32 / sizeof(T);
+    const __m256i needle = splat256(val);
+    size_t bits = 0;
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        bits += __builtin_popcount(static_cast<unsigned>(
+            _mm256_movemask_epi8(
+                lanes<T>::eq(load256(first + i), needle))));
+    }
+    size_t result = bits / sizeof(T);
+    for (; i < n; ++i) {
+        result += first[i] == val;
+    }
+    return result;
+}
+#endif
+
+/// index of the first element of `[first, first + n)` equal to
+/// `val`, or `n` if there is none.
+template <class T>
+size_t find(const T* first, size_t n, T val) {
+#ifdef PRELUDE_SIMD_X86
+    if (has_avx2()) {
+        return find_avx2(first, n, val);
+    }
+    return find_sse2(first, n, val);
+#else
+    for (size_t i = 0; i < n; ++i) {
+        if (first[i] == val) {
+            return i;
+        }
+    }
+    return n;
+#endif
+}
+
+/// number of elements of `[first, first + n)` equal to `val`.
+template <class T>
+size_t count(const T* first, size_t n, T val) {
+#ifdef PRELUDE_SIMD_X86
+    if (has_avx2()) {
+        return count_avx2(first, n, val);
+    }
+    return count_sse2(first, n, val);
+#else
+    size_t result = 0;
+    for (size_t i = 0; i < n; ++i) {
+        result += first[i] == val;
+    }
+    return result;
+#endif
+}
+
+/// true when `find`/`count` over `[Iterator, Iterator)` looking for a
+/// `T` can run on the kernels above.
+template <class Iterator, class T>
+struct is_searchable
+    : integral_constant<
+          bool,
+          is_contiguous_iterator<Iterator>::value and
+              is_same<typename std::iterator_traits<Iterator>::value_type,
+                      T>::value and
+              is_vectorizable<T>::value> {};
+
+template <class Iterator, class T>
+Iterator find(Iterator first, Iterator last, const T& val, true_type) {
+    if (first == last) {
+        return last;
+    }
+    return first + find(&*first, last - first, val);
+}
+
+template <class Iterator, class T>
+Iterator find(Iterator first, Iterator last, const T& val, false_type) {
+    return std::find(first, last, val);
+}
+
+template <class Iterator, class T>
+typename std::iterator_traits<Iterator>::difference_type count(
+    Iterator first, Iterator last, const T& val, true_type) {
+    if (first == last) {
+        return 0;
+    }
+    return count(&*first, last - first, val);
+}
+
+template <class Iterator, class T>
+typename std::iterator_traits<Iterator>::difference_type count(
+    Iterator first, Iterator last, const T& val, false_type) {
+    return std::count(first, last, val);
+}
+
+// Without a known comparison there is nothing to vectorize by hand,
+// but a branch free loop over the raw array lets the compiler do it
+// for predicates it can see through.
+template <class Iterator, class UnaryPredicate>
+typename std::iterator_traits<Iterator>::difference_type count_if(
+    Iterator first, Iterator last, UnaryPredicate pred, true_type) {
+    if (first == last) {
+        return 0;
+    }
+    const typename std::iterator_traits<Iterator>::value_type* data =
+        &*first;
+    size_t n = last - first;
+    size_t result = 0;
+    for (size_t i = 0; i < n; ++i) {
+        result += static_cast<bool>(pred(data[i]));
+    }
+    return result;
+}
+
+template <class Iterator, class UnaryPredicate>
+typename std::iterator_traits<Iterator>::difference_type count_if(
+    Iterator first, Iterator last, UnaryPredicate pred, false_type) {
+    return std::count_if(first, last, pred);
+}
+
+/// `std::find` that switches to the compare kernels for contiguous
+/// arithmetic ranges.
+template <class Iterator, class T>
+Iterator find(Iterator first, Iterator last, const T& val) {
+    return find(first, last, val,
+                integral_constant<bool,
+                                  is_searchable<Iterator, T>::value>());
+}
+
+template <class Iterator, class T>
+typename std::iterator_traits<Iterator>::difference_type count(
+    Iterator first, Iterator last, const T& val) {
+    return count(first, last, val,
+                 integral_constant<bool,
+                                   is_searchable<Iterator, T>::value>());
+}
+
+template <class Iterator, class UnaryPredicate>
+typename std::iterator_traits<Iterator>::difference_type count_if(
+    Iterator first, Iterator last, UnaryPredicate pred) {
+    return count_if(
+        first, last, pred,
+        integral_constant<bool,
+                          is_contiguous_iterator<Iterator>::value>());
+}
+
+// Sorted sets of 32 bit integers are compared four against four: every
+// rotation of the block from `b` is checked against the block from
+// `a`, which marks the elements of `a` present in `b`.  That would
+// match a value once per equal element it meets, so a block is only
+// compared whole when it and the element after it are strictly
+// increasing; around runs of equal values the kernels take scalar
+// merge steps instead.  An element a block matched but left in place
+// is smaller than everything left in the other range, so no later
+// step can match it again.
+#ifdef PRELUDE_SIMD_X86
+// whether `[i, n)` holds a block of four that is strictly increasing,
+// and less than the element after it if there is one.
+template <class T>
+bool is_set_block(const T* first, size_t i, size_t n) {
+    if (i + 4 > n) {
+        return false;
+    }
+    first += i;
+    if (i + 4 == n) {
+        return first[0] < first[1] and first[1] < first[2] and
+               first[2] < first[3];
+    }
+    // unsigned lanes compare as signed ones with their sign bits
+    // flipped.
+    const __m128i sign =
+        _mm_set1_epi32(is_signed<T>::value ? 0 : -2147483647 - 1);
+    __m128i lo = _mm_xor_si128(load128(first), sign);
+    __m128i hi = _mm_xor_si128(load128(first + 1), sign);
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(hi, lo))) ==
+           0xf;
+}
+
+inline unsigned block_matches(const void* a, const void* b) {
+    __m128i va = load128(a);
+    __m128i vb = load128(b);
+    __m128i eq = _mm_cmpeq_epi32(va, vb);
+    __m128i r1 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    __m128i r2 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i r3 = _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, r1));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, r2));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, r3));
+    return static_cast<unsigned>(
+        _mm_movemask_ps(_mm_castsi128_ps(eq)));
+}
+
+// the rest of the block of `a`, whose elements marked in `found` were
+// matched by blocks of `b` already passed.
+template <class T, class OutputIterator>
+OutputIterator finish_difference_block(const T* a, unsigned found,
+                                       const T* b, size_t& j,
+                                       size_t nb,
+                                       OutputIterator output) {
+    for (size_t k = 0; k < 4; ++k, found >>= 1) {
+        if (found & 1) {
+            continue;
+        }
+        while (j < nb and b[j] < a[k]) {
+            ++j;
+        }
+        if (j < nb and not(a[k] < b[j])) {
+            ++j;
+        } else {
+            *output = a[k];
+            ++output;
+        }
+    }
+    return output;
+}
+#endif
+
+template <class T, class OutputIterator>
+OutputIterator set_intersection(const T* a, size_t na, const T* b,
+                                size_t nb, OutputIterator output) {
+    size_t i = 0;
+    size_t j = 0;
+#ifdef PRELUDE_SIMD_X86
+    bool a_set = is_set_block(a, i, na);
+    bool b_set = is_set_block(b, j, nb);
+    while (i + 4 <= na and j + 4 <= nb) {
+        if (a_set and b_set) {
+            for (unsigned mask = block_matches(a + i, b + j); mask;
+                 mask &= mask - 1) {
+                *output = a[i + __builtin_ctz(mask)];
+                ++output;
+            }
+            T a_max = a[i + 3];
+            T b_max = b[j + 3];
+            i += a_max <= b_max ? 4 : 0;
+            j += b_max <= a_max ? 4 : 0;
+        } else if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            *output = a[i];
+            ++output;
+            ++i;
+            ++j;
+        }
+        a_set = is_set_block(a, i, na);
+        b_set = is_set_block(b, j, nb);
+    }
+#endif
+    return std::set_intersection(a + i, a + na, b + j, b + nb, output);
+}
+
+template <class T, class OutputIterator>
+OutputIterator set_difference(const T* a, size_t na, const T* b,
+                              size_t nb, OutputIterator output) {
+    size_t i = 0;
+    size_t j = 0;
+#ifdef PRELUDE_SIMD_X86
+    // the matches of the current block of `a` add up until no later
+    // block of `b` can contain any of its elements.
+    unsigned found = 0;
+    bool a_set = is_set_block(a, i, na);
+    bool b_set = is_set_block(b, j, nb);
+    while (i + 4 <= na and j + 4 <= nb) {
+        if (a_set and b_set) {
+            found |= block_matches(a + i, b + j);
+            T a_max = a[i + 3];
+            T b_max = b[j + 3];
+            if (a_max <= b_max) {
+                for (unsigned missing = ~found & 0xf; missing;
+                     missing &= missing - 1) {
+                    *output = a[i + __builtin_ctz(missing)];
+                    ++output;
+                }
+                found = 0;
+                i += 4;
+            }
+            j += b_max <= a_max ? 4 : 0;
+        } else if (found) {
+            output = finish_difference_block(a + i, found, b, j, nb,
+                                             output);
+            found = 0;
+            i += 4;
+        } else if (a[i] < b[j]) {
+            *output = a[i];
+            ++output;
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            ++i;
+            ++j;
+        }
+        a_set = is_set_block(a, i, na);
+        b_set = is_set_block(b, j, nb);
+    }
+    if (found) {
+        // `b` ran out part way through a block of `a`.
+        output = finish_difference_block(a + i, found, b, j, nb, output);
+        i += 4;
+    }
+#endif
+    return std::set_difference(a + i, a + na, b + j, b + nb, output);
+}
+
+/// true when the set operations over two `Iterator` ranges can use
+/// the block compare kernels.
+template <class Iterator1, class Iterator2>
+struct is_set_vectorizable
+    : integral_constant<
+          bool,
+          is_contiguous_iterator<Iterator1>::value and
+              is_contiguous_iterator<Iterator2>::value and
+              is_same<
+                  typename std::iterator_traits<Iterator1>::value_type,
+                  typename std::iterator_traits<Iterator2>::value_type>::
+                  value and
+              is_integral<typename std::iterator_traits<
+                  Iterator1>::value_type>::value and
+              sizeof(typename std::iterator_traits<
+                     Iterator1>::value_type) == 4> {};
+
+template <class Iterator1, class Iterator2, class OutputIterator>
+OutputIterator set_intersection(Iterator1 first1, Iterator1 last1,
+                                Iterator2 first2, Iterator2 last2,
+                                OutputIterator output, true_type) {
+    if (first1 == last1 or first2 == last2) {
+        return std::set_intersection(first1, last1, first2, last2,
+                                     output);
+    }
+    return set_intersection(&*first1, last1 - first1, &*first2,
+                            last2 - first2, output);
+}
+
+template <class Iterator1, class Iterator2, class OutputIterator>
+OutputIterator set_intersection(Iterator1 first1, Iterator1 last1,
+                                Iterator2 first2, Iterator2 last2,
+                                OutputIterator output, false_type) {
+    return std::set_intersection(first1, last1, first2, last2, output);
+}
+
+template <class Iterator1, class Iterator2, class OutputIterator>
+OutputIterator set_difference(Iterator1 first1, Iterator1 last1,
+                              Iterator2 first2, Iterator2 last2,
+                              OutputIterator output, true_type) {
+    if (first1 == last1 or first2 == last2) {
+        return std::set_difference(first1, last1, first2, last2,
+                                   output);
+    }
+    return set_difference(&*first1, last1 - first1, &*first2,
+                          last2 - first2, output);
+}
+
+template <class Iterator1, class Iterator2, class OutputIterator>
+OutputIterator set_difference(Iterator1 first1, Iterator1 last1,
+                              Iterator2 first2, Iterator2 last2,
+                              OutputIterator output, false_type) {
+    return std::set_difference(first1, last1, first2, last2, output);
+}
+
+/// `std::set_intersection` that compares blocks at a time when both
+/// ranges are contiguous 32 bit integers.  Runs of equal values are
+/// merged one element at a time, as `std::set_intersection` would.
+template <class Iterator1, class Iterator2, class OutputIterator>
+OutputIterator set_intersection(Iterator1 first1, Iterator1 last1,
+                                Iterator2 first2, Iterator2 last2,
+                                OutputIterator output) {
+    return set_intersection(
+        first1, last1, first2, last2, output,
+        integral_constant<
+            bool, is_set_vectorizable<Iterator1, Iterator2>::value>());
+}
+
+template <class Iterator1, class Iterator2, class OutputIterator>
+OutputIterator set_difference(Iterator1 first1, Iterator1 last1,
+                              Iterator2 first2, Iterator2 last2,
+                              OutputIterator output) {
+    return set_difference(
+        first1, last1, first2, last2, output,
+        integral_constant<
+            bool, is_set_vectorizable<Iterator1, Iterator2>::value>());
+}
+
+/// Comparisons against a constant, `x[i] op operand`, that
+/// `compare_mask` evaluates 64 elements at a time.
+enum comparison { cmp_none, cmp_eq, cmp_ne, cmp_lt, cmp_gt, cmp_le, cmp_ge };
+
+/// the comparison `Comp` performs on two `T`s, or `cmp_none`.
+template <class Comp, class T>
+struct comparison_of : integral_constant<comparison, cmp_none> {};
+template <class T>
+struct comparison_of<std::equal_to<T>, T>
+    : integral_constant<comparison, cmp_eq> {};
+template <class T>
+struct comparison_of<std::not_equal_to<T>, T>
+    : integral_constant<comparison, cmp_ne> {};
+template <class T>
+struct comparison_of<std::less<T>, T>
+    : integral_constant<comparison, cmp_lt> {};
+template <class T>
+struct comparison_of<std::greater<T>, T>
+    : integral_constant<comparison, cmp_gt> {};
+template <class T>
+struct comparison_of<std::less_equal<T>, T>
+    : integral_constant<comparison, cmp_le> {};
+template <class T>
+struct comparison_of<std::greater_equal<T>, T>
+    : integral_constant<comparison, cmp_ge> {};
+
+template <comparison Op, class T>
+bool holds(T x, T operand) {
+    switch (Op) {
+    case cmp_eq:
+        return x == operand;
+    case cmp_ne:
+        return x != operand;
+    case cmp_lt:
+        return x < operand;
+    case cmp_gt:
+        return x > operand;
+    case cmp_le:
+        return x <= operand;
+    case cmp_ge:
+        return x >= operand;
+    default:
+        return false;
+    }
+}
+
+/// the value whose bits flip unsigned lanes into signed order.  Signed
+/// and floating point lanes are in order already.
+template <class T, bool Integral = is_integral<T>::value>
+struct sign_bit {
+    static T value() { return T(); }
+};
+
+template <class T>
+struct sign_bit<T, true> {
+    static T value() {
+        const T ones = T(~T());
+        return is_signed<T>::value ? T() : T(ones ^ T(ones >> 1));
+    }
+};
+
+#ifdef PRELUDE_SIMD_X86
+template <comparison Op, class T>
+__m128i compare(__m128i x, __m128i operand) {
+    switch (Op) {
+    case cmp_eq:
+        return lanes<T>::eq(x, operand);
+    case cmp_ne:
+        return lanes<T>::ne(x, operand);
+    case cmp_lt:
+        return lanes<T>::gt(operand, x);
+    case cmp_gt:
+        return lanes<T>::gt(x, operand);
+    case cmp_le:
+        return lanes<T>::ge(operand, x);
+    default:
+        return lanes<T>::ge(x, operand);
+    }
+}
+
+template <comparison Op, class T>
+PRELUDE_TARGET_AVX2 __m256i compare(__m256i x, __m256i operand) {
+    switch (Op) {
+    case cmp_eq:
+        return lanes<T>::eq(x, operand);
+    case cmp_ne:
+        return lanes<T>::ne(x, operand);
+    case cmp_lt:
+        return lanes<T>::gt(operand, x);
+    case cmp_gt:
+        return lanes<T>::gt(x, operand);
+    case cmp_le:
+        return lanes<T>::ge(operand, x);
+    default:
+        return lanes<T>::ge(x, operand);
+    }
+}
+
+template <comparison Op, class T>
+uint64_t compare_block_sse2(const T* x, T operand) {
+    const size_t width = 16 / sizeof(T);
+    const __m128i sign = splat128(sign_bit<T>::value());
+    const __m128i needle = _mm_xor_si128(splat128(operand), sign);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; i += width) {
+        __m128i v = _mm_xor_si128(load128(x + i), sign);
+        mask |= uint64_t(lanes<T>::bits(compare<Op, T>(v, needle))) << i;
+    }
+    return mask;
+}
+
+template <comparison Op, class T>
+PRELUDE_TARGET_AVX2 uint64_t compare_block_avx2(const T* x, T operand) {
+    const size_t width = 32 / sizeof(T);
+    const __m256i sign = splat256(sign_bit<T>::value());
+    const __m256i needle = _mm256_xor_si256(splat256(operand), sign);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; i += width) {
+        __m256i v = _mm256_xor_si256(load256(x + i), sign);
+        mask |= uint64_t(lanes<T>::bits(compare<Op, T>(v, needle))) << i;
+    }
+    return mask;
+}
+#endif
+
+/// packs `n <= 64` flags of 0 or 1 into the bits of a mask.  Eight
+/// flags at a time are gathered into the top byte by one multiply.
+inline uint64_t pack_flags(const unsigned char* flags, size_t n) {
+    uint64_t mask = 0;
+    size_t i = 0;
+#if defined(__BYTE_ORDER__) and __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        memcpy(&word, flags + i, 8);
+        mask |= ((word * 0x0102040810204080ull) >> 56) << i;
+    }
+#endif
+    for (; i < n; ++i) {
+        mask |= uint64_t(flags[i]) << i;
+    }
+    return mask;
+}
+
+/// mask with bit `i` set when `x[i] op operand`, for `n <= 64`.  Only
+/// whole blocks of 64 go through the vector kernels.
+template <comparison Op, class T>
+uint64_t compare_mask(const T* x, size_t n, T operand) {
+#ifdef PRELUDE_SIMD_X86
+    if (n == 64) {
+        if (has_avx2()) {
+            return compare_block_avx2<Op>(x, operand);
+        }
+        return compare_block_sse2<Op>(x, operand);
+    }
+#endif
+    unsigned char flags[64];
+    for (size_t i = 0; i < n; ++i) {
+        flags[i] = holds<Op>(x[i], operand);
+    }
+    return pack_flags(flags, n);
+}
+
+/// element types `divisible_mask` has a vector kernel for: the integers
+/// whose word the divisibility test runs in fills whole lanes.
+template <class T>
+struct is_divisibility_vectorizable
+    : integral_constant<bool, is_integral<T>::value and
+                                  not is_same<T, bool>::value and
+                                  (sizeof(T) == 4 or sizeof(T) == 8)> {};
+
+#ifdef PRELUDE_SIMD_X86
+template <size_t Size>
+struct divisibility_lanes;
+
+// the steps of `DivisibilityPredicate`'s test on 32 bit words.
+template <>
+struct divisibility_lanes<4> {
+    PRELUDE_TARGET_AVX2 static __m256i magnitude(__m256i v, false_type) {
+        return v;
+    }
+    // the most negative value maps to itself, which read unsigned is
+    // its magnitude.
+    PRELUDE_TARGET_AVX2 static __m256i magnitude(__m256i v, true_type) {
+        return _mm256_abs_epi32(v);
+    }
+    PRELUDE_TARGET_AVX2 static __m256i multiply(__m256i a, __m256i b) {
+        return _mm256_mullo_epi32(a, b);
+    }
+    // shifting by the whole width gives 0, so a rotate by 0 works.
+    PRELUDE_TARGET_AVX2 static __m256i rotate(__m256i v, unsigned shift) {
+        return _mm256_or_si256(
+            _mm256_srl_epi32(v, _mm_cvtsi32_si128(int(shift))),
+            _mm256_sll_epi32(v, _mm_cvtsi32_si128(int(32 - shift))));
+    }
+    PRELUDE_TARGET_AVX2 static unsigned at_most(__m256i v, __m256i limit) {
+        return lanes<uint32_t>::bits(
+            _mm256_cmpeq_epi32(_mm256_min_epu32(v, limit), v));
+    }
+};
+
+// the same on 64 bit words, which AVX2 has no multiply, absolute value
+// or unsigned compare for.
+template <>
+struct divisibility_lanes<8> {
+    PRELUDE_TARGET_AVX2 static __m256i magnitude(__m256i v, false_type) {
+        return v;
+    }
+    PRELUDE_TARGET_AVX2 static __m256i magnitude(__m256i v, true_type) {
+        __m256i negative = _mm256_cmpgt_epi64(_mm256_setzero_si256(), v);
+        return _mm256_sub_epi64(_mm256_xor_si256(v, negative), negative);
+    }
+    // the low 64 bits of `a * b` from the 32 bit halves: the high
+    // halves only reach the result through the cross products.
+    PRELUDE_TARGET_AVX2 static __m256i multiply(__m256i a, __m256i b) {
+        __m256i low = _mm256_mul_epu32(a, b);
+        __m256i cross = _mm256_add_epi64(
+            _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+            _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+    }
+    PRELUDE_TARGET_AVX2 static __m256i rotate(__m256i v, unsigned shift) {
+        return _mm256_or_si256(
+            _mm256_srl_epi64(v, _mm_cvtsi32_si128(int(shift))),
+            _mm256_sll_epi64(v, _mm_cvtsi32_si128(int(64 - shift))));
+    }
+    PRELUDE_TARGET_AVX2 static unsigned at_most(__m256i v, __m256i limit) {
+        const __m256i sign = _mm256_set1_epi64x(-9223372036854775807ll - 1);
+        __m256i above = _mm256_cmpgt_epi64(_mm256_xor_si256(v, sign),
+                                           _mm256_xor_si256(limit, sign));
+        return ~lanes<uint64_t>::bits(above) & 0xf;
+    }
+};
+
+template <class T, class Word>
+PRELUDE_TARGET_AVX2 uint64_t divisible_block_avx2(const T* x, Word inverse,
+                                                   unsigned shift,
+                                                   Word limit) {
+    typedef divisibility_lanes<sizeof(T)> ops;
+    const size_t width = 32 / sizeof(T);
+    const __m256i multiplier = splat256(inverse);
+    const __m256i bound = splat256(limit);
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 64; i += width) {
+        __m256i v = ops::magnitude(
+            load256(x + i), integral_constant<bool, is_signed<T>::value>());
+        v = ops::rotate(ops::multiply(v, multiplier), shift);
+        mask |= uint64_t(ops::at_most(v, bound)) << i;
+    }
+    return mask;
+}
+#endif
+
+template <class T, class Pred>
+uint64_t divisible_mask(const T* x, size_t n, const Pred& pred, false_type) {
+    unsigned char flags[64];
+    for (size_t i = 0; i < n; ++i) {
+        flags[i] = pred(x[i]);
+    }
+    return pack_flags(flags, n);
+}
+
+template <class T, class Pred>
+uint64_t divisible_mask(const T* x, size_t n, const Pred& pred, true_type) {
+#ifdef PRELUDE_SIMD_X86
+    if (n == 64 and has_avx2()) {
+        return divisible_block_avx2(x, pred.inverse(), pred.shift(),
+                                    pred.limit());
+    }
+#endif
+    return divisible_mask(x, n, pred, false_type());
+}
+
+/// mask with bit `i` set when `pred(x[i])`, for `n <= 64`, where `pred`
+/// is a `DivisibilityPredicate<T>`.  Whole blocks of 64 run its
+/// multiply, rotate and compare in AVX2 lanes when the CPU has them.
+template <class T, class Pred>
+uint64_t divisible_mask(const T* x, size_t n, const Pred& pred) {
+    return divisible_mask(x, n, pred, is_divisibility_vectorizable<T>());
+}
+
+/// element types whose zero is all zero bits, so a terminator can be
+/// found by comparing bytes.
+template <class T>
+struct is_zero_scannable
+    : integral_constant<bool, (is_integral<T>::value or
+                               is_pointer<T>::value) and
+                                  (sizeof(T) == 1 or sizeof(T) == 2 or
+                                   sizeof(T) == 4 or sizeof(T) == 8)> {};
+
+#ifdef PRELUDE_SIMD_X86
+// Aligned loads never cross a page boundary, so reading the whole
+// vector holding the terminator can't fault even when it's the last
+// thing mapped.  Lanes before `first` are masked off.
+template <class T>
+PRELUDE_NO_SANITIZE unsigned zero_mask128(const char* block) {
+    __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(block));
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(lanes<T>::eq(v, _mm_setzero_si128())));
+}
+
+template <class T>
+PRELUDE_TARGET_AVX2 PRELUDE_NO_SANITIZE unsigned zero_mask256(
+    const char* block) {
+    __m256i v =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(block));
+    return static_cast<unsigned>(
+        _mm256_movemask_epi8(lanes<T>::eq(v, _mm256_setzero_si256())));
+}
+
+template <class T>
+const T* find_zero_sse2(const T* first) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(first);
+    const char* block =
+        reinterpret_cast<const char*>(address & ~uintptr_t(15));
+    unsigned mask = zero_mask128<T>(block) & (~0u << (address & 15));
+    while (not mask) {
+        block += 16;
+        mask = zero_mask128<T>(block);
+    }
+    return reinterpret_cast<const T*>(block + __builtin_ctz(mask));
+}
+
+template <class T>
+PRELUDE_TARGET_AVX2 const T* find_zero_avx2(const T* first) {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(first);
+    const char* block =
+        reinterpret_cast<const char*>(address & ~uintptr_t(31));
+    unsigned mask = zero_mask256<T>(block) & (~0u << (address & 31));
+    while (not mask) {
+        block += 32;
+        mask = zero_mask256<T>(block);
+    }
+    return reinterpret_cast<const T*>(block + __builtin_ctz(mask));
+}
+#endif
+
+template <class T>
+const T* find_zero(const T* first, false_type) {
+    for (; *first != 0; ++first) {
+    }
+    return first;
+}
+
+template <class T>
+const T* find_zero(const T* first, true_type) {
+#ifdef PRELUDE_SIMD_X86
+    // a misaligned array would put elements across vector lanes.
+    if (reinterpret_cast<uintptr_t>(first) % sizeof(T) == 0) {
+        if (has_avx2()) {
+            return find_zero_avx2(first);
+        }
+        return find_zero_sse2(first);
+    }
+#endif
+    return find_zero(first, false_type());
+}
+
+/// the first element of the zero terminated array at `first` that is
+/// zero (or null).
+template <class T>
+const T* find_zero(const T* first) {
+    return find_zero(
+        first, integral_constant<bool, is_zero_scannable<T>::value>());
+}
+
+}
+}
+
+#endif
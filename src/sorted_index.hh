@@ -0,0 +1,170 @@
+#ifndef HEADER_GUARD_SORTED_INDEX_H
+#define HEADER_GUARD_SORTED_INDEX_H
+
+#include <stddef.h>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace prelude {
+
+/// read only copy of a sorted range laid out in Eytzinger (breadth
+/// first) order, so that the first levels of every search share cache
+/// lines and the next levels can be prefetched.  Searches return the
+/// position the answer has in the original range.
+///
+/// `T` must be default constructible.
+template <class T, class Compare = std::less<T> >
+class SortedIndex {
+    // 1 based: the children of `k` are `2k` and `2k + 1`.
+    std::vector<T> keys;
+    std::vector<size_t> positions;
+    Compare comp;
+
+    size_t build(const std::vector<T>& sorted, size_t i, size_t k) {
+        if (k < keys.size()) {
+            i = build(sorted, i, 2 * k);
+            keys[k] = sorted[i];
+            positions[k] = i;
+            ++i;
+            i = build(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    void prefetch(size_t k) const {
+#if defined(__GNUC__) or defined(__clang__)
+        // the descendants four levels down share a cache line once
+        // `T` is small enough; fetch them while comparing this level.
+        const size_t per_line = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+        if (k * per_line < keys.size()) {
+            __builtin_prefetch(&keys[k * per_line]);
+        }
+#else
+        (void)k;
+#endif
+    }
+
+    // After the descent `k` encodes the path taken; the answer is the
+    // last node where we went left, found by dropping the trailing
+    // right turns (ones) and the left turn before them.
+    static size_t last_left_turn(size_t k) {
+#if defined(__GNUC__) or defined(__clang__)
+        return k >> __builtin_ffsll(~static_cast<unsigned long long>(k));
+#else
+        while (k & 1) {
+            k >>= 1;
+        }
+        return k >> 1;
+#endif
+    }
+
+    template <class U>
+    size_t lower_node(const U& val) const {
+        size_t k = 1;
+        while (k < keys.size()) {
+            prefetch(k);
+            k = 2 * k + comp(keys[k], val);
+        }
+        return last_left_turn(k);
+    }
+
+    template <class U>
+    size_t upper_node(const U& val) const {
+        size_t k = 1;
+        while (k < keys.size()) {
+            prefetch(k);
+            k = 2 * k + not comp(val, keys[k]);
+        }
+        return last_left_turn(k);
+    }
+
+    size_t position(size_t node) const {
+        return node == 0 ? size() : positions[node];
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    SortedIndex()
+        : keys(1)
+        , positions(1) {}
+
+    /// `[first, last)` must be sorted by `comp`.
+    template <class InputIterator>
+    SortedIndex(InputIterator first, InputIterator last,
+                Compare comp = Compare())
+        : comp(comp) {
+        std::vector<T> sorted(first, last);
+        keys.resize(sorted.size() + 1);
+        positions.resize(sorted.size() + 1);
+        build(sorted, 0, 1);
+    }
+
+    size_type size() const { return keys.size() - 1; }
+    bool empty() const { return size() == 0; }
+
+    /// position of the first element not less than `val`, or `size()`.
+    template <class U>
+    size_type lower_bound(const U& val) const {
+        return position(lower_node(val));
+    }
+
+    /// position of the first element greater than `val`, or `size()`.
+    template <class U>
+    size_type upper_bound(const U& val) const {
+        return position(upper_node(val));
+    }
+
+    template <class U>
+    std::pair<size_type, size_type> equal_range(const U& val) const {
+        return std::pair<size_type, size_type>(lower_bound(val),
+                                               upper_bound(val));
+    }
+
+    template <class U>
+    bool binary_search(const U& val) const {
+        size_t node = lower_node(val);
+        return node != 0 and not comp(val, keys[node]);
+    }
+};
+
+template <class Container>
+SortedIndex<typename Container::value_type> sorted_index(
+    const Container& container) {
+    return SortedIndex<typename Container::value_type>(
+        container.begin(), container.end());
+}
+
+template <class Container, class Compare>
+SortedIndex<typename Container::value_type, Compare> sorted_index_with(
+    const Container& container, Compare comp) {
+    return SortedIndex<typename Container::value_type, Compare>(
+        container.begin(), container.end(), comp);
+}
+
+template <class T, class Compare, class U>
+size_t lower_bound(const SortedIndex<T, Compare>& index, const U& val) {
+    return index.lower_bound(val);
+}
+
+template <class T, class Compare, class U>
+size_t upper_bound(const SortedIndex<T, Compare>& index, const U& val) {
+    return index.upper_bound(val);
+}
+
+template <class T, class Compare, class U>
+std::pair<size_t, size_t> equal_range(
+    const SortedIndex<T, Compare>& index, const U& val) {
+    return index.equal_range(val);
+}
+
+template <class T, class Compare, class U>
+bool binary_search(const SortedIndex<T, Compare>& index, const U& val) {
+    return index.binary_search(val);
+}
+
+}
+
+#endif
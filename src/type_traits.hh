@@ -24,6 +24,14 @@ namespace prelude {
 using ::std::integral_constant;
 using ::std::true_type;
 using ::std::false_type;
+
+using ::std::is_same;
+using ::std::is_integral;
+using ::std::is_floating_point;
+using ::std::is_arithmetic;
+using ::std::is_signed;
+using ::std::is_trivially_copyable;
+using ::std::is_pointer;
 }
 
 #else
@@ -34,7 +42,7 @@ struct integral_constant {
     static const T value = v;
     typedef T value_type;
     typedef integral_constant<T, v> type;
-    const operator T() const { return v; }
+    operator T() const { return v; }
 };
 
 typedef integral_constant<bool, true> true_type;
@@ -56,6 +64,66 @@ struct is_floating_point<double> : true_type {};
 template <>
 struct is_floating_point<long double> : true_type {};
 
+template <class A, class B>
+struct is_same : false_type {};
+template <class A>
+struct is_same<A, A> : true_type {};
+
+template <class T>
+struct is_integral : false_type {};
+template <>
+struct is_integral<bool> : true_type {};
+template <>
+struct is_integral<char> : true_type {};
+template <>
+struct is_integral<signed char> : true_type {};
+template <>
+struct is_integral<unsigned char> : true_type {};
+template <>
+struct is_integral<wchar_t> : true_type {};
+template <>
+struct is_integral<short> : true_type {};
+template <>
+struct is_integral<unsigned short> : true_type {};
+template <>
+struct is_integral<int> : true_type {};
+template <>
+struct is_integral<unsigned int> : true_type {};
+template <>
+struct is_integral<long> : true_type {};
+template <>
+struct is_integral<unsigned long> : true_type {};
+template <>
+struct is_integral<long long> : true_type {};
+template <>
+struct is_integral<unsigned long long> : true_type {};
+template <class T>
+struct is_integral<const T> : is_integral<T> {};
+
+template <class T>
+struct is_arithmetic
+    : integral_constant<bool, is_integral<T>::value or
+                                  is_floating_point<T>::value> {};
+
+// `T(-1) < T(0)` is only a constant expression for integral `T`.
+template <class T, bool Integral = is_integral<T>::value>
+struct is_signed : is_floating_point<T> {};
+template <class T>
+struct is_signed<T, true> : integral_constant<bool, (T(-1) < T(0))> {};
+
+template <class T>
+struct is_pointer : false_type {};
+template <class T>
+struct is_pointer<T*> : true_type {};
+template <class T>
+struct is_pointer<T* const> : true_type {};
+
+// conservative: only what is certainly safe to `memcpy`.
+template <class T>
+struct is_trivially_copyable : is_arithmetic<T> {};
+template <class T>
+struct is_trivially_copyable<T*> : true_type {};
+
 template <class T>
 struct is_function_impl : false_type {};
 template <class Ret, class A>
@@ -0,0 +1,407 @@
+#ifndef HEADER_GUARD_VIEW_H
+#define HEADER_GUARD_VIEW_H
+
+#include <stddef.h>
+#include <iterator>
+#if __cplusplus >= 201103L
+#include <type_traits>
+#include <utility>
+#endif
+
+namespace prelude {
+/// Lazy views over containers.  A view only stores its source and its
+/// functions, so views can be stacked without any intermediate
+/// container: the work is done one element at a time by whichever
+/// algorithm walks the outermost view, or by `materialize`.
+///
+/// Views never own the container at the bottom of the stack; it has
+/// to outlive them.
+namespace view {
+
+// The friend `begin` and `end` of every view are exact matches, so
+// they win over `std::begin` found through the source's namespace.
+#define PRELUDE_VIEW_BEGIN_END(View)                                   \
+    typedef iterator const_iterator;                                   \
+    friend iterator begin(const View& v) { return v.begin(); }         \
+    friend iterator end(const View& v) { return v.end(); }
+
+/// a view of `[first, last)`.
+template <class Iterator>
+class Range {
+    Iterator first;
+    Iterator last;
+
+public:
+    typedef Iterator iterator;
+    typedef typename std::iterator_traits<Iterator>::value_type
+        value_type;
+    PRELUDE_VIEW_BEGIN_END(Range)
+
+    Range(Iterator first, Iterator last)
+        : first(first)
+        , last(last) {}
+
+    iterator begin() const { return first; }
+    iterator end() const { return last; }
+};
+
+// Containers are viewed through their iterators, views are copied.
+template <class Source>
+struct range_of {
+    typedef Range<typename Source::const_iterator> type;
+    static type get(const Source& source) {
+        return type(source.begin(), source.end());
+    }
+};
+
+template <class Source>
+struct view_range_of {
+    typedef Source type;
+    static const type& get(const Source& source) { return source; }
+};
+
+template <class Iterator>
+struct range_of<Range<Iterator> > : view_range_of<Range<Iterator> > {};
+
+template <class Iterator, class Category =
+              typename std::iterator_traits<Iterator>::iterator_category>
+struct forward_category {
+    typedef std::forward_iterator_tag type;
+};
+template <class Iterator>
+struct forward_category<Iterator, std::input_iterator_tag> {
+    typedef std::input_iterator_tag type;
+};
+
+template <class Source, class Predicate>
+class Filter {
+    typedef typename Source::iterator source_iterator;
+    Source source;
+    Predicate pred;
+
+public:
+    class iterator {
+        source_iterator it;
+        source_iterator last;
+        Predicate pred;
+
+        void skip() {
+            while (it != last and not pred(*it)) {
+                ++it;
+            }
+        }
+
+    public:
+        typedef typename std::iterator_traits<
+            source_iterator>::value_type value_type;
+        typedef typename std::iterator_traits<
+            source_iterator>::difference_type difference_type;
+        typedef typename std::iterator_traits<source_iterator>::pointer
+            pointer;
+        typedef typename std::iterator_traits<
+            source_iterator>::reference reference;
+        typedef typename forward_category<source_iterator>::type
+            iterator_category;
+
+        iterator(source_iterator it, source_iterator last,
+                 Predicate pred)
+            : it(it)
+            , last(last)
+            , pred(pred) {
+            skip();
+        }
+
+        reference operator*() const { return *it; }
+        iterator& operator++() {
+            ++it;
+            skip();
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const iterator& other) const {
+            return it == other.it;
+        }
+        bool operator!=(const iterator& other) const {
+            return it != other.it;
+        }
+    };
+    typedef typename iterator::value_type value_type;
+    PRELUDE_VIEW_BEGIN_END(Filter)
+
+    Filter(const Source& source, Predicate pred)
+        : source(source)
+        , pred(pred) {}
+
+    iterator begin() const {
+        return iterator(source.begin(), source.end(), pred);
+    }
+    iterator end() const {
+        return iterator(source.end(), source.end(), pred);
+    }
+};
+
+template <class Source, class Function>
+class Transform {
+    typedef typename Source::iterator source_iterator;
+    Source source;
+    Function function;
+
+public:
+    class iterator {
+        source_iterator it;
+        Function function;
+
+    public:
+#if __cplusplus >= 201103L
+        typedef typename std::decay<decltype(std::declval<Function&>()(
+            *std::declval<source_iterator>()))>::type value_type;
+#else
+        typedef typename Function::result_type value_type;
+#endif
+        typedef typename std::iterator_traits<
+            source_iterator>::difference_type difference_type;
+        typedef const value_type* pointer;
+        // computed on every dereference, so there is nothing to refer
+        // to.
+        typedef value_type reference;
+        typedef typename forward_category<source_iterator>::type
+            iterator_category;
+
+        iterator(source_iterator it, Function function)
+            : it(it)
+            , function(function) {}
+
+        value_type operator*() const { return function(*it); }
+        iterator& operator++() {
+            ++it;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++it;
+            return old;
+        }
+        bool operator==(const iterator& other) const {
+            return it == other.it;
+        }
+        bool operator!=(const iterator& other) const {
+            return it != other.it;
+        }
+    };
+    typedef typename iterator::value_type value_type;
+    PRELUDE_VIEW_BEGIN_END(Transform)
+
+    Transform(const Source& source, Function function)
+        : source(source)
+        , function(function) {}
+
+    iterator begin() const { return iterator(source.begin(), function); }
+    iterator end() const { return iterator(source.end(), function); }
+};
+
+template <class Source>
+class Take {
+    typedef typename Source::iterator source_iterator;
+    Source source;
+    size_t n;
+
+public:
+    class iterator {
+        source_iterator it;
+        source_iterator last;
+        size_t left;
+
+    public:
+        typedef typename std::iterator_traits<
+            source_iterator>::value_type value_type;
+        typedef typename std::iterator_traits<
+            source_iterator>::difference_type difference_type;
+        typedef typename std::iterator_traits<source_iterator>::pointer
+            pointer;
+        typedef typename std::iterator_traits<
+            source_iterator>::reference reference;
+        typedef typename forward_category<source_iterator>::type
+            iterator_category;
+
+        iterator(source_iterator it, source_iterator last, size_t left)
+            : it(it)
+            , last(last)
+            , left(left) {
+            if (it == last) {
+                this->left = 0;
+            }
+        }
+
+        reference operator*() const { return *it; }
+        iterator& operator++() {
+            // stop right away so no element past the `n`th is ever
+            // computed.
+            if (--left != 0) {
+                ++it;
+                if (it == last) {
+                    left = 0;
+                }
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const iterator& other) const {
+            return left == other.left and
+                   (left == 0 or it == other.it);
+        }
+        bool operator!=(const iterator& other) const {
+            return not(*this == other);
+        }
+    };
+    typedef typename iterator::value_type value_type;
+    PRELUDE_VIEW_BEGIN_END(Take)
+
+    Take(const Source& source, size_t n)
+        : source(source)
+        , n(n) {}
+
+    iterator begin() const {
+        return iterator(source.begin(), source.end(), n);
+    }
+    iterator end() const {
+        return iterator(source.end(), source.end(), 0);
+    }
+};
+
+template <class Source>
+class Unique {
+    typedef typename Source::iterator source_iterator;
+    Source source;
+
+public:
+    class iterator {
+        source_iterator it;
+        source_iterator last;
+
+    public:
+        typedef typename std::iterator_traits<
+            source_iterator>::value_type value_type;
+        typedef typename std::iterator_traits<
+            source_iterator>::difference_type difference_type;
+        typedef typename std::iterator_traits<source_iterator>::pointer
+            pointer;
+        typedef typename std::iterator_traits<
+            source_iterator>::reference reference;
+        // every step looks at the element after the current one.
+        typedef std::forward_iterator_tag iterator_category;
+
+        iterator(source_iterator it, source_iterator last)
+            : it(it)
+            , last(last) {}
+
+        reference operator*() const { return *it; }
+        iterator& operator++() {
+            value_type current = *it;
+            while (++it != last and *it == current) {
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const iterator& other) const {
+            return it == other.it;
+        }
+        bool operator!=(const iterator& other) const {
+            return it != other.it;
+        }
+    };
+    typedef typename iterator::value_type value_type;
+    PRELUDE_VIEW_BEGIN_END(Unique)
+
+    explicit Unique(const Source& source)
+        : source(source) {}
+
+    iterator begin() const {
+        return iterator(source.begin(), source.end());
+    }
+    iterator end() const { return iterator(source.end(), source.end()); }
+};
+
+#undef PRELUDE_VIEW_BEGIN_END
+
+template <class Source, class Predicate>
+struct range_of<Filter<Source, Predicate> >
+    : view_range_of<Filter<Source, Predicate> > {};
+template <class Source, class Function>
+struct range_of<Transform<Source, Function> >
+    : view_range_of<Transform<Source, Function> > {};
+template <class Source>
+struct range_of<Take<Source> > : view_range_of<Take<Source> > {};
+template <class Source>
+struct range_of<Unique<Source> > : view_range_of<Unique<Source> > {};
+
+template <class Iterator>
+Range<Iterator> range(Iterator first, Iterator last) {
+    return Range<Iterator>(first, last);
+}
+
+/// the elements of `source` that satisfy `pred`.
+template <class Source, class Predicate>
+Filter<typename range_of<Source>::type, Predicate> filter(
+    const Source& source, Predicate pred) {
+    return Filter<typename range_of<Source>::type, Predicate>(
+        range_of<Source>::get(source), pred);
+}
+
+/// `function(element)` for every element of `source`, computed when
+/// it is read.
+template <class Source, class Function>
+Transform<typename range_of<Source>::type, Function> transform(
+    const Source& source, Function function) {
+    return Transform<typename range_of<Source>::type, Function>(
+        range_of<Source>::get(source), function);
+}
+
+/// the first `n` elements of `source`.
+template <class Source>
+Take<typename range_of<Source>::type> take(const Source& source,
+                                           size_t n) {
+    return Take<typename range_of<Source>::type>(
+        range_of<Source>::get(source), n);
+}
+
+/// `source` with runs of equal elements collapsed to their first.
+template <class Source>
+Unique<typename range_of<Source>::type> unique(const Source& source) {
+    return Unique<typename range_of<Source>::type>(
+        range_of<Source>::get(source));
+}
+
+}
+
+/// runs the view pipeline once, appending every element to `output`.
+template <class View, class Container>
+Container& materialize(const View& view, Container& output) {
+    typename View::iterator last = view.end();
+    for (typename View::iterator it = view.begin(); it != last; ++it) {
+        output.push_back(*it);
+    }
+    return output;
+}
+
+template <class Container, class View>
+Container materialize(const View& view) {
+    Container output;
+    materialize(view, output);
+    return output;
+}
+
+}
+
+#endif
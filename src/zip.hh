@@ -0,0 +1,266 @@
+#ifndef HEADER_GUARD_ZIP_H
+#define HEADER_GUARD_ZIP_H
+
+#include <stddef.h>
+#include <algorithm>
+#include <iterator>
+#if __cplusplus >= 201103L
+#include <utility>
+#endif
+#include "view.hh"
+
+namespace prelude {
+
+/// Structure of arrays columns walked together.  `*it` of a
+/// `ZipIterator` is a `ZipReference` whose `first` and `second` refer
+/// into the two columns, so sorting, partitioning or rotating the
+/// zipped range permutes every column in place without building a
+/// vector of pairs.  The first column is the key: zipped elements are
+/// ordered by `first` alone.  Zip a zip to carry more columns.
+
+template <class It1, class It2>
+class ZipReference;
+
+/// an element taken out of a zipped range.  `*it` is a temporary
+/// whether or not it is moved from, so elements are always copied out
+/// of the columns; swaps still move.
+template <class T1, class T2>
+struct ZipValue {
+    T1 first;
+    T2 second;
+
+    ZipValue()
+        : first()
+        , second() {}
+    ZipValue(const T1& first, const T2& second)
+        : first(first)
+        , second(second) {}
+
+    template <class It1, class It2>
+    ZipValue(const ZipReference<It1, It2>& other)
+        : first(other.first)
+        , second(other.second) {}
+
+    template <class It1, class It2>
+    ZipValue& operator=(const ZipReference<It1, It2>& other) {
+        first = other.first;
+        second = other.second;
+        return *this;
+    }
+};
+
+/// refers to one element of each column.  Assigning to it assigns
+/// through to the columns.
+template <class It1, class It2>
+class ZipReference {
+public:
+    typedef typename std::iterator_traits<It1>::reference first_type;
+    typedef typename std::iterator_traits<It2>::reference second_type;
+    typedef ZipValue<typename std::iterator_traits<It1>::value_type,
+                     typename std::iterator_traits<It2>::value_type>
+        value_type;
+
+    first_type first;
+    second_type second;
+
+    ZipReference(first_type first, second_type second)
+        : first(first)
+        , second(second) {}
+
+    // copies refer to the same elements; only assignment writes
+    // through.
+    ZipReference(const ZipReference& other)
+        : first(other.first)
+        , second(other.second) {}
+
+    ZipReference& operator=(const ZipReference& other) {
+        first = other.first;
+        second = other.second;
+        return *this;
+    }
+
+    ZipReference& operator=(const value_type& other) {
+        first = other.first;
+        second = other.second;
+        return *this;
+    }
+
+#if __cplusplus >= 201103L
+    ZipReference& operator=(value_type&& other) {
+        first = std::move(other.first);
+        second = std::move(other.second);
+        return *this;
+    }
+#endif
+};
+
+// `*it` is a temporary, so `std::swap` can't take it.
+template <class It1, class It2>
+void swap(ZipReference<It1, It2> a, ZipReference<It1, It2> b) {
+    using std::swap;
+    swap(a.first, b.first);
+    swap(a.second, b.second);
+}
+
+template <class It1, class It2>
+bool operator<(const ZipReference<It1, It2>& a,
+               const ZipReference<It1, It2>& b) {
+    return a.first < b.first;
+}
+
+template <class It1, class It2, class T1, class T2>
+bool operator<(const ZipReference<It1, It2>& a,
+               const ZipValue<T1, T2>& b) {
+    return a.first < b.first;
+}
+
+template <class It1, class It2, class T1, class T2>
+bool operator<(const ZipValue<T1, T2>& a,
+               const ZipReference<It1, It2>& b) {
+    return a.first < b.first;
+}
+
+template <class T1, class T2>
+bool operator<(const ZipValue<T1, T2>& a, const ZipValue<T1, T2>& b) {
+    return a.first < b.first;
+}
+
+/// compares zipped elements by applying `comp` to their keys.
+template <class Compare>
+struct ZipCompare {
+    Compare comp;
+
+    template <class A, class B>
+    bool operator()(const A& a, const B& b) const {
+        return comp(a.first, b.first);
+    }
+};
+
+template <class Compare>
+ZipCompare<Compare> zip_compare(Compare comp) {
+    ZipCompare<Compare> zip_comp = {comp};
+    return zip_comp;
+}
+
+/// random access iterator over two random access columns.
+template <class It1, class It2>
+class ZipIterator {
+    It1 first;
+    It2 second;
+
+public:
+    typedef ZipReference<It1, It2> reference;
+    typedef typename reference::value_type value_type;
+    typedef typename std::iterator_traits<It1>::difference_type
+        difference_type;
+    // there is no element in memory to point to.
+    typedef void pointer;
+    typedef std::random_access_iterator_tag iterator_category;
+
+    ZipIterator()
+        : first()
+        , second() {}
+    ZipIterator(It1 first, It2 second)
+        : first(first)
+        , second(second) {}
+
+    It1 first_column() const { return first; }
+    It2 second_column() const { return second; }
+
+    reference operator*() const { return reference(*first, *second); }
+    reference operator[](difference_type n) const {
+        return reference(first[n], second[n]);
+    }
+
+    ZipIterator& operator++() {
+        ++first;
+        ++second;
+        return *this;
+    }
+    ZipIterator operator++(int) {
+        ZipIterator old = *this;
+        ++*this;
+        return old;
+    }
+    ZipIterator& operator--() {
+        --first;
+        --second;
+        return *this;
+    }
+    ZipIterator operator--(int) {
+        ZipIterator old = *this;
+        --*this;
+        return old;
+    }
+    ZipIterator& operator+=(difference_type n) {
+        first += n;
+        second += n;
+        return *this;
+    }
+    ZipIterator& operator-=(difference_type n) {
+        first -= n;
+        second -= n;
+        return *this;
+    }
+    ZipIterator operator+(difference_type n) const {
+        return ZipIterator(first + n, second + n);
+    }
+    ZipIterator operator-(difference_type n) const {
+        return ZipIterator(first - n, second - n);
+    }
+    friend ZipIterator operator+(difference_type n,
+                                 const ZipIterator& it) {
+        return it + n;
+    }
+    difference_type operator-(const ZipIterator& other) const {
+        return first - other.first;
+    }
+
+    // the columns move together, so the first one decides.
+    bool operator==(const ZipIterator& other) const {
+        return first == other.first;
+    }
+    bool operator!=(const ZipIterator& other) const {
+        return first != other.first;
+    }
+    bool operator<(const ZipIterator& other) const {
+        return first < other.first;
+    }
+    bool operator>(const ZipIterator& other) const {
+        return first > other.first;
+    }
+    bool operator<=(const ZipIterator& other) const {
+        return first <= other.first;
+    }
+    bool operator>=(const ZipIterator& other) const {
+        return first >= other.first;
+    }
+};
+
+/// `[first1, last1)` zipped with the column starting at `first2`.
+template <class It1, class It2>
+view::Range<ZipIterator<It1, It2> > zip(It1 first1, It1 last1,
+                                        It2 first2) {
+    return view::Range<ZipIterator<It1, It2> >(
+        ZipIterator<It1, It2>(first1, first2),
+        ZipIterator<It1, It2>(last1, first2 + (last1 - first1)));
+}
+
+/// `column1` zipped with `column2`, which must be at least as long.
+template <class Container1, class Container2>
+view::Range<ZipIterator<typename Container1::iterator,
+                        typename Container2::iterator> >
+zip(Container1& column1, Container2& column2) {
+    return zip(column1.begin(), column1.end(), column2.begin());
+}
+
+// zips nest: `zip(keys, zip(a, b))`.
+template <class Container1, class Iterator>
+view::Range<ZipIterator<typename Container1::iterator, Iterator> > zip(
+    Container1& column1, const view::Range<Iterator>& column2) {
+    return zip(column1.begin(), column1.end(), column2.begin());
+}
+
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "catch.hpp"
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "../src/adaptive_predicate.hh"
+#include "../src/algorithm.hh"
+
+using namespace prelude;
+
+static std::vector<int> random_ints(size_t n) {
+    std::vector<int> ints;
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        ints.push_back(static_cast<int>(state % 1000));
+    }
+    return ints;
+}
+
+TEST_CASE("adaptive::reorder keeps the results") {
+    std::vector<int> ints = random_ints(20000);
+    adaptive::Predicate<int> pred = adaptive::reorder(
+        is_greater_than(-1) and is_divisible_by(3) and is_less_than(10),
+        8, 256);
+    REQUIRE(pred.statistics().size() == 3);
+    REQUIRE_FALSE(pred.is_disjunction());
+    for (size_t i = 0; i < ints.size(); ++i) {
+        int x = ints[i];
+        REQUIRE(pred(x) == (x > -1 and x % 3 == 0 and x < 10));
+    }
+
+    adaptive::Predicate<int> any = adaptive::reorder(
+        is_equal_to(5) or is_divisible_by(7) or is_greater_than(-1), 8,
+        256);
+    REQUIRE(any.is_disjunction());
+    for (size_t i = 0; i < ints.size(); ++i) {
+        REQUIRE(any(ints[i]));
+    }
+    REQUIRE_FALSE(any(-3));
+}
+
+TEST_CASE("adaptive::reorder puts the deciding clause first") {
+    std::vector<int> ints = random_ints(20000);
+
+    // the first clause always passes, so it can never end an `and`.
+    adaptive::Predicate<int> all = adaptive::reorder(
+        is_greater_than(-1) and is_less_than(10), 8, 256);
+    REQUIRE(count_if(ints, all) ==
+            std::count_if(ints.begin(), ints.end(), is_less_than(10)));
+    REQUIRE(all.order()[0] == 1);
+    REQUIRE(all.order()[1] == 0);
+
+    // copies share the statistics.
+    REQUIRE(all.calls() == ints.size());
+    const std::vector<adaptive::ClauseStatistics>& stats =
+        all.statistics();
+    REQUIRE(stats[0].pass_rate() == 1.0);
+    REQUIRE(stats[1].pass_rate() < 0.05);
+    REQUIRE(stats[0].samples == ints.size() / 8);
+    REQUIRE(stats[1].calls == ints.size());
+    // once reordered the first clause is hardly ever reached.
+    REQUIRE(stats[0].calls < ints.size() / 4);
+
+    // and it always ends an `or`.
+    adaptive::Predicate<int> any = adaptive::reorder(
+        is_less_than(10) or is_greater_than(-1), 8, 256);
+    REQUIRE(count_if(ints, any) == static_cast<ptrdiff_t>(ints.size()));
+    REQUIRE(any.order()[0] == 1);
+}
+
+TEST_CASE("adaptive::reorder of a single clause") {
+    adaptive::Predicate<int> pred = adaptive::reorder(is_less_than(3));
+    REQUIRE(pred.statistics().size() == 1);
+    REQUIRE(pred(2));
+    REQUIRE_FALSE(pred(3));
+
+    // nested `or`s are one clause of the `and`.
+    adaptive::Predicate<int> nested = adaptive::reorder(
+        (is_less_than(3) or is_greater_than(10)) and is_divisible_by(2));
+    REQUIRE(nested.statistics().size() == 2);
+    REQUIRE(nested(12));
+    REQUIRE_FALSE(nested(13));
+    REQUIRE_FALSE(nested(6));
+
+    adaptive::Predicate<int> copy = nested;
+    copy = pred;
+    REQUIRE(copy.statistics().size() == 1);
+}
@@ -1,3 +1,5 @@
+#include <list>
+#include <string>
 #include <vector>
 #include "catch.hpp"
 
@@ -6,8 +8,6 @@
 
 using namespace prelude;
 
-#if __cplusplus >= 201103L
-
 TEST_CASE("all_of") {
     std::vector<int> vec;
 
@@ -43,6 +43,20 @@ TEST_CASE("none_of") {
     REQUIRE_FALSE(none_of(vec, is_equal_to(5)));
 }
 
+TEST_CASE("find and count on contiguous containers") {
+    std::vector<unsigned char> bytes(100, 'a');
+    bytes[77] = 'b';
+    bytes[90] = 'b';
+    REQUIRE(find(bytes, 'b') == bytes.begin() + 77);
+    REQUIRE(count(bytes, 'b') == 2);
+    REQUIRE(count_if(bytes, is_equal_to<unsigned char>('a')) == 98);
+
+    std::vector<int> ints(33, 5);
+    REQUIRE(find(ints, 6) == ints.end());
+    // a differently typed value takes the generic path
+    REQUIRE(count(ints, 5L) == 33);
+}
+
 #include <iostream>
 TEST_CASE("swap_ranges") {
     std::vector<int> vec1;
@@ -58,10 +72,9 @@ TEST_CASE("swap_ranges") {
     // all three should be equivalent
     SECTION("") { swap_ranges(vec1, vec2); }
     SECTION("") {
-        swap_ranges(std::begin(vec1), std::end(vec1),
-                    std::begin(vec2));
+        swap_ranges(begin(vec1), end(vec1), begin(vec2));
     }
-    SECTION("") { swap_ranges_i(vec1, std::begin(vec2)); }
+    SECTION("") { swap_ranges_i(vec1, begin(vec2)); }
 
     REQUIRE(vec1[0] == 4);
     REQUIRE(vec1[1] == 5);
@@ -200,4 +213,443 @@ TEST_CASE("unique_copy 2") {
     REQUIRE(copy[2] == 3);
 }
 
+TEST_CASE("sort_parallel") {
+    std::vector<int> vec;
+    for (int i = 0; i < 200000; ++i) {
+        vec.push_back((i * 7919) % 100003 - 50000);
+    }
+    std::vector<int> expected = vec;
+    std::sort(expected.begin(), expected.end());
+
+    SECTION("less") {
+        sort_parallel(vec);
+        REQUIRE(vec == expected);
+    }
+
+    SECTION("greater") {
+        sort_parallel_with(vec, std::greater<int>());
+        std::reverse(expected.begin(), expected.end());
+        REQUIRE(vec == expected);
+    }
+
+    SECTION("mostly duplicates") {
+        for (size_t i = 0; i < vec.size(); ++i) {
+            vec[i] %= 3;
+        }
+        expected = vec;
+        std::sort(expected.begin(), expected.end());
+        sort_parallel(vec.begin(), vec.end());
+        REQUIRE(vec == expected);
+    }
+
+    SECTION("more threads than cores") {
+        parallel::sort(vec.begin(), vec.end(), std::less<int>(), 8);
+        REQUIRE(vec == expected);
+    }
+}
+
+TEST_CASE("lower_bound_batch and upper_bound_batch") {
+    std::vector<int> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i / 4 * 3);
+    }
+
+    std::vector<int> keys;
+    for (int i = 0; i < 300; ++i) {
+        keys.push_back((i * 7919) % 800 - 10);
+    }
+
+    SECTION("unsorted keys") {}
+    SECTION("sorted keys") { std::sort(keys.begin(), keys.end()); }
+
+    typedef std::vector<int>::iterator iterator;
+    std::vector<iterator> lower, upper;
+    lower_bound_batch(vec, keys.begin(), keys.end(),
+                      std::back_inserter(lower));
+    upper_bound_batch(vec.begin(), vec.end(), keys.begin(), keys.end(),
+                      std::back_inserter(upper));
+    REQUIRE(lower.size() == keys.size());
+    REQUIRE(upper.size() == keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(lower[i] ==
+                std::lower_bound(vec.begin(), vec.end(), keys[i]));
+        REQUIRE(upper[i] ==
+                std::upper_bound(vec.begin(), vec.end(), keys[i]));
+    }
+}
+
+TEST_CASE("lower_bound_batch_with on an empty range") {
+    std::vector<int> vec;
+    std::vector<int> keys(3, 1);
+    std::vector<std::vector<int>::iterator> out;
+    lower_bound_batch_with(vec, keys.begin(), keys.end(),
+                           std::back_inserter(out), std::less<int>());
+    REQUIRE(out.size() == 3);
+    REQUIRE(out[0] == vec.end());
+}
+
+TEST_CASE("set_intersection and set_difference of sorted id vectors") {
+    std::vector<int> evens, thirds;
+    for (int i = 0; i < 300; ++i) {
+        evens.push_back(i * 2);
+        thirds.push_back(i * 3);
+    }
+    std::vector<int> both = set_intersection(evens, thirds);
+    std::vector<int> only_evens = set_difference(evens, thirds);
+    REQUIRE(both.size() == 100);
+    REQUIRE(only_evens.size() == 200);
+    for (size_t i = 0; i < both.size(); ++i) {
+        REQUIRE(both[i] == static_cast<int>(i) * 6);
+    }
+    for (size_t i = 0; i < only_evens.size(); ++i) {
+        REQUIRE(only_evens[i] % 6 != 0);
+    }
+}
+
+TEST_CASE("galloping merge and set operations on skewed inputs") {
+    std::vector<int> big, small;
+    for (int i = 0; i < 5000; ++i) {
+        big.push_back(i / 2);
+    }
+    small.push_back(-3);
+    small.push_back(7);
+    small.push_back(7);
+    small.push_back(1200);
+    small.push_back(9000);
+
+    std::vector<int> expected, actual;
+    std::merge(big.begin(), big.end(), small.begin(), small.end(),
+               std::back_inserter(expected));
+    merge_galloping(big, small, std::back_inserter(actual));
+    REQUIRE(actual == expected);
+
+    expected.clear();
+    actual.clear();
+    std::set_intersection(big.begin(), big.end(), small.begin(),
+                          small.end(), std::back_inserter(expected));
+    set_intersection_galloping(small.begin(), small.end(), big.begin(),
+                               big.end(), std::back_inserter(actual));
+    REQUIRE(actual == expected);
+
+    expected.clear();
+    actual.clear();
+    std::set_difference(big.begin(), big.end(), small.begin(),
+                        small.end(), std::back_inserter(expected));
+    set_difference_galloping(big, small, std::back_inserter(actual));
+    REQUIRE(actual == expected);
+
+    REQUIRE_FALSE(includes_galloping(big, small));
+    small.erase(small.begin());
+    small.pop_back();
+    REQUIRE(includes_galloping(big, small));
+    small.push_back(7);
+    REQUIRE_FALSE(includes_galloping(big, small));
+}
+
+struct FirstLess {
+    bool operator()(const std::pair<int, int>& a,
+                    const std::pair<int, int>& b) const {
+        return a.first < b.first;
+    }
+};
+
+TEST_CASE("merge_galloping_with is stable") {
+    std::vector<std::pair<int, int> > a, b;
+    for (int i = 0; i < 100; ++i) {
+        a.push_back(std::make_pair(i / 10, 1));
+    }
+    b.push_back(std::make_pair(3, 2));
+    b.push_back(std::make_pair(3, 2));
+    b.push_back(std::make_pair(5, 2));
+    std::vector<std::pair<int, int> > expected, actual;
+    std::merge(a.begin(), a.end(), b.begin(), b.end(),
+               std::back_inserter(expected), FirstLess());
+    merge_galloping_with(a.begin(), a.end(), b.begin(), b.end(),
+                         std::back_inserter(actual), FirstLess());
+    REQUIRE(actual == expected);
+}
+
+TEST_CASE("merge_parallel matches merge") {
+    // keys repeat so that stability shows up in the second member.
+    std::vector<std::pair<int, int> > a, b;
+    for (int i = 0; i < 40000; ++i) {
+        a.push_back(std::make_pair(i / 7, 1));
+        b.push_back(std::make_pair(i / 3, 2));
+    }
+    std::vector<std::pair<int, int> > expected;
+    std::vector<std::pair<int, int> > actual(a.size() + b.size());
+    std::merge(a.begin(), a.end(), b.begin(), b.end(),
+               std::back_inserter(expected), FirstLess());
+    REQUIRE(merge_parallel_with(a, b, actual.begin(), FirstLess()) ==
+            actual.end());
+    REQUIRE(actual == expected);
+
+    std::fill(actual.begin(), actual.end(), std::make_pair(0, 0));
+    parallel::merge(a.begin(), a.end(), b.begin(), b.end(),
+                    actual.begin(), FirstLess(), 8);
+    REQUIRE(actual == expected);
+
+    std::vector<std::pair<int, int> > joined = a;
+    joined.insert(joined.end(), b.begin(), b.end());
+    parallel::inplace_merge(joined.begin(), joined.begin() + a.size(),
+                            joined.end(), FirstLess(), 8);
+    REQUIRE(joined == expected);
+}
+
+TEST_CASE("parallel::co_rank") {
+    int a[] = {1, 2, 2, 5};
+    int b[] = {2, 3};
+    // the merge is 1 2a 2a 2b 3 5
+    REQUIRE(parallel::co_rank(0, a, 4, b, 2, std::less<int>()) == 0);
+    REQUIRE(parallel::co_rank(3, a, 4, b, 2, std::less<int>()) == 3);
+    REQUIRE(parallel::co_rank(4, a, 4, b, 2, std::less<int>()) == 3);
+    REQUIRE(parallel::co_rank(5, a, 4, b, 2, std::less<int>()) == 3);
+    REQUIRE(parallel::co_rank(6, a, 4, b, 2, std::less<int>()) == 4);
+}
+
+#if __cplusplus >= 201103L
+TEST_CASE("append moves out of rvalues") {
+    std::vector<std::string> vec1(2, "a");
+    std::vector<std::string> vec2(3, "b");
+    append(vec1, std::move(vec2));
+    REQUIRE(vec1.size() == 5);
+    REQUIRE(vec1[1] == "a");
+    REQUIRE(vec1[4] == "b");
+
+    // an empty destination takes the source's buffer.
+    std::vector<std::string> empty;
+    const std::string* data = &vec1[0];
+    append(empty, std::move(vec1));
+    REQUIRE(&empty[0] == data);
+    REQUIRE(empty.size() == 5);
+}
+#endif
+
+TEST_CASE("append_copy into a buffer") {
+    std::vector<int> vec1(3, 1);
+    std::vector<int> vec2(2, 2);
+    int buffer[6] = {0, 0, 0, 0, 0, 9};
+    REQUIRE(append_copy(vec1, vec2, buffer) == buffer + 5);
+    int expected[6] = {1, 1, 1, 2, 2, 9};
+    REQUIRE(std::equal(buffer, buffer + 6, expected));
+
+    std::vector<int> reused(100, 7);
+    const int* data = &reused[0];
+    append_copy_into(vec1, vec2, reused);
+    REQUIRE(reused.size() == 5);
+    REQUIRE(&reused[0] == data);
+    REQUIRE(reused[2] == 1);
+    REQUIRE(reused[3] == 2);
+}
+
+struct IsMultipleOf3 {
+    bool operator()(int i) const { return i % 3 == 0; }
+};
+
+struct AtomicAdd {
+    long* sum;
+    void operator()(int i) const { __sync_fetch_and_add(sum, i); }
+};
+
+// never splits and walks a vector through the default `next_chunk`.
+struct Sequential : Iterator<int> {
+    std::vector<int>::iterator it;
+    std::vector<int>::iterator last;
+    Sequential& operator++() {
+        ++it;
+        return *this;
+    }
+    int* get() const { return it == last ? NULL : &*it; }
+};
+
+// counts up to `last` in chunks of up to 64, written over one buffer.
+struct Reusing : Iterator<int> {
+    int buffer[64];
+    int next;
+    int last;
+    Reusing& operator++() {
+        ++next;
+        return *this;
+    }
+    int* get() const { return NULL; }
+    int* next_chunk(size_type& size) {
+        if (next == last) {
+            return NULL;
+        }
+        size = std::min(64, last - next);
+        for (size_type i = 0; i < size; ++i) {
+            buffer[i] = next++;
+        }
+        return buffer;
+    }
+};
+
+TEST_CASE("parallel visits split iterators evenly") {
+    std::vector<int> vec(1000000);
+    VectorIterator<int> vit = iterator(vec);
+    parallel::ForEachVisit<AtomicAdd> visit = {{NULL}};
+    parallel::IteratorVisitor<int, parallel::ForEachVisit<AtomicAdd> >
+        visitor(visit);
+    visitor.split(vit, 32);
+    REQUIRE(visitor.pieces.size() == 32);
+    size_t total = 0;
+    for (size_t i = 0; i < visitor.pieces.size(); ++i) {
+        size_t size = visitor.pieces[i]->count();
+        REQUIRE(size <= 2 * vec.size() / 32);
+        total += size;
+    }
+    REQUIRE(total == vec.size());
+}
+
+TEST_CASE("count_if and for_each over splittable and sequential iterators") {
+    std::vector<int> vec;
+    for (int i = 0; i < 50000; ++i) {
+        vec.push_back(i);
+    }
+    VectorIterator<int> vit = iterator(vec);
+    REQUIRE(count_if_parallel(vit, IsMultipleOf3()) == 16667);
+
+    Sequential sequential;
+    sequential.it = vec.begin();
+    sequential.last = vec.end();
+    REQUIRE(parallel::count_if(sequential, IsMultipleOf3(), 4) == 16667);
+
+    long sum = 0;
+    AtomicAdd add = {&sum};
+    VectorIterator<int> vit2 = iterator(vec);
+    for_each_parallel(vit2, add);
+    REQUIRE(sum == 50000L * 49999 / 2);
+
+    sum = 0;
+    sequential.it = vec.begin();
+    parallel::for_each(sequential, add, 3);
+    REQUIRE(sum == 50000L * 49999 / 2);
+
+    sequential.it = vec.begin();
+    REQUIRE(parallel::count_if(sequential, IsMultipleOf3(), 1) == 16667);
+
+    // longer chunks are batched across storage the iterator reuses.
+    Reusing reusing;
+    reusing.next = 0;
+    reusing.last = 50000;
+    REQUIRE(parallel::count_if(reusing, IsMultipleOf3(), 4) == 16667);
+    sum = 0;
+    reusing.next = 0;
+    parallel::for_each(reusing, add, 3);
+    REQUIRE(sum == 50000L * 49999 / 2);
+}
+
+struct TableAt {
+    const std::vector<int>* table;
+    const int* operator()(size_t i) const { return &(*table)[i]; }
+};
+
+TEST_CASE("prefetching gathers") {
+    std::vector<int> table;
+    std::vector<size_t> indices;
+    for (int i = 0; i < 1000; ++i) {
+        table.push_back(i * 2);
+        indices.push_back((i * 7919) % 1000);
+    }
+    TableAt at = {&table};
+    typedef view::Range<prefetch::Adapter<
+        std::vector<size_t>::const_iterator, TableAt> >
+        Gather;
+    Gather gather = prefetching(indices, 16, at);
+    long sum = 0;
+    for (Gather::iterator it = gather.begin(); it != gather.end(); ++it) {
+        sum += table[*it];
+    }
+    REQUIRE(sum == 999L * 1000);
+
+    // shorter than the distance, and empty.
+    std::vector<size_t> few(indices.begin(), indices.begin() + 3);
+    REQUIRE(count_if(prefetching(few, 16, at), IsMultipleOf3()) ==
+            std::count_if(few.begin(), few.end(), IsMultipleOf3()));
+    REQUIRE(count(prefetching(std::vector<size_t>(), 4), 1) == 0);
+
+    std::vector<const int*> pointers;
+    for (size_t i = 0; i < indices.size(); ++i) {
+        pointers.push_back(&table[indices[i]]);
+    }
+    view::Range<prefetch::Adapter<std::vector<const int*>::iterator,
+                                  prefetch::pointee> >
+        range = prefetching(pointers.begin(), pointers.end(), 8,
+                            prefetch::pointee());
+    REQUIRE(std::equal(range.begin(), range.end(), pointers.begin()));
+}
+
+struct Negate {
+    int operator()(int i) const { return -i; }
+};
+
+TEST_CASE("Container returning algorithms reserve their result once") {
+    std::vector<int> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(i / 2);
+    }
+    std::vector<int> odds;
+    for (int i = 1; i < 3000; i += 2) {
+        odds.push_back(i);
+    }
+
+    // exact sizes.
+    std::vector<int> merged = merge(vec, odds);
+    REQUIRE(merged.size() == 2500);
+    REQUIRE(merged.capacity() == 2500);
+    REQUIRE(is_sorted(merged));
+    std::vector<int> negated = transform(vec, Negate());
+    REQUIRE(negated.capacity() == 1000);
+    REQUIRE(negated[999] == -499);
+
+    // bounds, given back with PRELUDE_SHRINK_RESULTS.
+#ifdef PRELUDE_SHRINK_RESULTS
+    const size_t bound_1000 = 0;
+#else
+    const size_t bound_1000 = 1000;
 #endif
+    std::vector<int> unique = unique_copy_with(vec, std::equal_to<int>());
+    REQUIRE(unique.size() == 500);
+    REQUIRE(unique.capacity() == std::max<size_t>(500, bound_1000));
+    std::vector<int> removed = remove_copy_if(vec, IsMultipleOf3());
+    REQUIRE(removed.capacity() == std::max(removed.size(), bound_1000));
+    std::vector<int> both = set_union(unique, odds);
+    REQUIRE(both.size() == 1750);
+    REQUIRE(both.capacity() == std::max<size_t>(1750, 2 * bound_1000));
+    std::pair<std::vector<int>, std::vector<int> > parts =
+        partition_copy(vec, IsMultipleOf3());
+    REQUIRE(parts.first.size() + parts.second.size() == 1000);
+    REQUIRE(parts.first.capacity() ==
+            std::max(parts.first.size(), bound_1000));
+
+    std::vector<int> smallest = partial_sort_copy(odds, 3);
+    REQUIRE(smallest.size() == 3);
+    REQUIRE(smallest[2] == 5);
+
+    shrink_result(removed, true_type());
+    REQUIRE(removed.capacity() == removed.size());
+
+    // containers that can't reserve just fill up.
+    std::list<int> list(vec.begin(), vec.end());
+    REQUIRE(unique_copy(list).size() == 500);
+    REQUIRE(has_reserve<std::vector<int> >::value);
+    REQUIRE(has_reserve<std::string>::value);
+    REQUIRE(not has_reserve<std::list<int> >::value);
+}
+
+TEST_CASE("set operations keep duplicates") {
+    int a_values[] = {1, 1, 2, 2, 2, 3, 5, 8, 8};
+    int b_values[] = {1, 2, 2, 4, 5, 5, 8, 9, 9};
+    std::vector<int> a(a_values, a_values + 9);
+    std::vector<int> b(b_values, b_values + 9);
+    std::vector<int> intersection, difference;
+    set_intersection(a, b, std::back_inserter(intersection));
+    set_difference(a, b, std::back_inserter(difference));
+    int expected_intersection[] = {1, 2, 2, 5, 8};
+    int expected_difference[] = {1, 2, 3, 8};
+    REQUIRE(intersection ==
+            std::vector<int>(expected_intersection,
+                             expected_intersection + 5));
+    REQUIRE(difference ==
+            std::vector<int>(expected_difference, expected_difference + 4));
+}
@@ -0,0 +1,162 @@
+#include "catch.hpp"
+
+#include <stdint.h>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include "../src/algorithm.hh"
+#include "../src/compiled_predicate.hh"
+
+using namespace prelude;
+
+static std::vector<int> random_ints(size_t n) {
+    std::vector<int> ints;
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        ints.push_back(static_cast<int>(state % 40) - 10);
+    }
+    return ints;
+}
+
+static bool expected(int x) {
+    return (x > 3 and x < 10) or x == -5;
+}
+
+struct Unexpected {
+    bool operator()(int x) const { return not expected(x); }
+};
+
+TEST_CASE("compiled predicates match their scalar results") {
+    std::vector<int> ints = random_ints(1000);
+    // every length up to two blocks and a bit, for the partial masks.
+    for (size_t n = 0; n < 150; ++n) {
+        const int* first = ints.empty() ? NULL : &ints[0];
+        size_t count = 0;
+        size_t found = n;
+        for (size_t i = 0; i < n; ++i) {
+            if (expected(ints[i])) {
+                count += 1;
+                found = std::min(found, i);
+            }
+        }
+        REQUIRE(compiled::count(first, n,
+                                compiled::compile(
+                                    (is_greater_than(3) and
+                                     is_less_than(10)) or
+                                    is_equal_to(-5))) == count);
+        REQUIRE(compiled::find(first, n,
+                               compiled::compile(
+                                   (is_greater_than(3) and
+                                    is_less_than(10)) or
+                                   is_equal_to(-5))) == found);
+    }
+}
+
+TEST_CASE("compiled count_if and find_if") {
+    std::vector<int> ints = random_ints(1000);
+    REQUIRE((compiled::compiler<BinaryPredicate<int, less<int> > >::value));
+
+    REQUIRE(count_if(ints, (is_greater_than(3) and is_less_than(10)) or
+                               is_equal_to(-5)) ==
+            std::count_if(ints.begin(), ints.end(), expected));
+    REQUIRE(find_if(ints, (is_greater_than(3) and is_less_than(10)) or
+                              is_equal_to(-5)) ==
+            std::find_if(ints.begin(), ints.end(), expected));
+    REQUIRE(find_if(ints, is_greater_than(100)) == ints.end());
+    REQUIRE(count_if(ints, not is_less_than(0)) ==
+            std::count_if(ints.begin(), ints.end(),
+                          is_greater_than_or_equal_to(0)));
+
+    std::vector<int> empty;
+    REQUIRE(count_if(empty, is_less_than(0)) == 0);
+    REQUIRE(find_if(empty, is_less_than(0)) == empty.end());
+}
+
+TEST_CASE("compiled remove_if and partition") {
+    std::vector<int> ints = random_ints(1000);
+
+    std::vector<int> removed = ints;
+    std::vector<int> kept;
+    std::remove_copy_if(ints.begin(), ints.end(),
+                        std::back_inserter(kept), expected);
+    remove_if(removed, (is_greater_than(3) and is_less_than(10)) or
+                           is_equal_to(-5));
+    REQUIRE(removed == kept);
+
+    std::vector<int> partitioned = ints;
+    std::vector<int>::iterator middle =
+        partition(partitioned, (is_greater_than(3) and is_less_than(10)) or
+                                   is_equal_to(-5));
+    REQUIRE(middle - partitioned.begin() ==
+            std::count_if(ints.begin(), ints.end(), expected));
+    REQUIRE(std::find_if(partitioned.begin(), middle, Unexpected()) ==
+            middle);
+    REQUIRE(std::find_if(middle, partitioned.end(), expected) ==
+            partitioned.end());
+    std::sort(partitioned.begin(), partitioned.end());
+    std::sort(ints.begin(), ints.end());
+    REQUIRE(partitioned == ints);
+}
+
+TEST_CASE("compiled select") {
+    std::vector<int> ints = random_ints(200);
+    std::vector<size_t> indices;
+    compiled::select(ints.begin(), ints.end(),
+                     is_greater_than(3) and is_less_than(10),
+                     std::back_inserter(indices));
+    std::vector<size_t> expected_indices;
+    for (size_t i = 0; i < ints.size(); ++i) {
+        if (ints[i] > 3 and ints[i] < 10) {
+            expected_indices.push_back(i);
+        }
+    }
+    REQUIRE(indices == expected_indices);
+}
+
+TEST_CASE("compiled all_of, any_of and none_of") {
+    std::vector<int> ints = random_ints(1000);
+    REQUIRE(all_of(ints, is_greater_than_or_equal_to(-10) and
+                             is_less_than(30)));
+    REQUIRE_FALSE(all_of(ints, is_less_than(29)));
+    REQUIRE(any_of(ints, is_equal_to(29)));
+    REQUIRE(none_of(ints, is_greater_than(29) or is_less_than(-10)));
+
+    // the one element that fails is in the scalar tail.
+    ints.push_back(100);
+    REQUIRE_FALSE(all_of(ints, is_less_than(30)));
+    REQUIRE(any_of(ints, is_equal_to(100)));
+
+    std::vector<long> longs(ints.begin(), ints.end());
+    REQUIRE(count_if(longs, is_less_than(0)) ==
+            count_if(ints, is_less_than(0)));
+}
+
+TEST_CASE("compiled compile time bounds") {
+    std::vector<int> ints = random_ints(1000);
+    REQUIRE((compiled::compiler<ConstantPredicate<int, 3, less<int> > >::
+                 value));
+    REQUIRE(count_if(ints, (is_greater_than<3>() and is_less_than<10>()) or
+                               is_equal_to(-5)) ==
+            std::count_if(ints.begin(), ints.end(), expected));
+    REQUIRE(all_of(ints, is_less_than<30>()));
+}
+
+TEST_CASE("compiled is_divisible_by") {
+    std::vector<int> ints = random_ints(1000);
+    std::vector<int> expected_ints;
+    for (size_t i = 0; i < ints.size(); ++i) {
+        if (ints[i] % 3 == 0 and ints[i] > 0) {
+            expected_ints.push_back(ints[i]);
+        }
+    }
+    std::vector<int> partitioned = ints;
+    partitioned.erase(
+        partition(partitioned, is_divisible_by(3) and is_greater_than(0)),
+        partitioned.end());
+    std::sort(partitioned.begin(), partitioned.end());
+    std::sort(expected_ints.begin(), expected_ints.end());
+    REQUIRE(partitioned == expected_ints);
+}
@@ -1,4 +1,6 @@
 #include "catch.hpp"
+#include <stdlib.h>
+#include <unistd.h>
 #include "../src/iterator.hh"
 
 using namespace prelude;
@@ -52,3 +54,351 @@ TEST_CASE("begin end for array of strings") {
     REQUIRE(end_null(ptr) - ptr == 5);
     REQUIRE(end_null(ptr) == ptr + 5);
 }
+
+TEST_CASE("end_null") {
+    int ints[] = {3, 2, 1, 0, 5};
+    const int* const_ints = ints;
+    REQUIRE(end_null(ints) == ints + 3);
+    REQUIRE(end_null(const_ints) == ints + 3);
+    const wchar_t* wide = L"wide string";
+    REQUIRE(end_null(wide) == wide + 11);
+    double doubles[] = {1.5, -0.0, 2};
+    REQUIRE(end_null(doubles) == doubles + 1);
+}
+
+// walks the base class interface only, so `VectorIterator` is only
+// recognized through its override.
+static int sum_chunks(Iterator<int>& it, size_t& chunks) {
+    int sum = 0;
+    chunks = 0;
+    size_t size;
+    for (int* chunk = it.next_chunk(size); chunk;
+         chunk = it.next_chunk(size)) {
+        for (size_t i = 0; i < size; ++i) {
+            sum += chunk[i];
+        }
+        ++chunks;
+    }
+    REQUIRE(size == 0);
+    return sum;
+}
+
+struct Strided : Iterator<int> {
+    int* first;
+    int* last;
+    Strided(int* first, int* last) : first(first), last(last) {}
+    Strided& operator++() {
+        first += 2;
+        return *this;
+    }
+    int* get() const { return first < last ? first : NULL; }
+};
+
+TEST_CASE("next_chunk") {
+    std::vector<int> vec;
+    for (int i = 1; i <= 10; ++i) {
+        vec.push_back(i);
+    }
+    VectorIterator<int> vit = iterator(vec);
+    size_t chunks;
+    REQUIRE(sum_chunks(vit, chunks) == 55);
+    REQUIRE(chunks == 1);
+    REQUIRE(vit.get() == NULL);
+
+    Strided odds(&vec[0], &vec[0] + vec.size());
+    REQUIRE(sum_chunks(odds, chunks) == 25);
+    REQUIRE(chunks == 5);
+}
+
+// only provides the required members, the rest come from the base.
+struct StaticStrided : StaticIterator<StaticStrided, int> {
+    int* it;
+    int* stop;
+    StaticStrided(int* first, int* last) : it(first), stop(last) {}
+    StaticStrided& operator++() {
+        it += 2;
+        return *this;
+    }
+    int* get() const { return it < stop ? it : NULL; }
+};
+
+TEST_CASE("StaticIterator defaults") {
+    int array[] = {1, 2, 3, 4, 5, 6, 7};
+    StaticStrided odds(array, array + 7);
+    REQUIRE(*odds == 1);
+    REQUIRE(odds.nth(1) == array + 2);
+    REQUIRE(odds.last() == array + 6);
+    REQUIRE(odds.get() == NULL);
+    REQUIRE(StaticStrided(array, array + 7).count() == 4);
+}
+
+TEST_CASE("static_iterator and virtual_iterator") {
+    std::vector<int> vec;
+    for (int i = 1; i <= 10; ++i) {
+        vec.push_back(i);
+    }
+    StaticVectorIterator<int> sit = static_iterator(vec);
+    size_t size;
+    REQUIRE(sit.min_size(size));
+    REQUIRE(size == 10);
+    REQUIRE(*sit.nth(3) == 4);
+    REQUIRE(sit.count() == 7);
+
+    VirtualIterator<StaticStrided> vit =
+        virtual_iterator(StaticStrided(&vec[0], &vec[0] + vec.size()));
+    Iterator<int>* it = &vit;
+    size_t chunks;
+    REQUIRE(sum_chunks(*it, chunks) == 25);
+    REQUIRE(chunks == 5);
+}
+
+struct Record {
+    int key;
+    int value;
+};
+
+TEST_CASE("MappedArray") {
+    char path[] = "/tmp/prelude-mmap-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    std::vector<Record> records;
+    for (int i = 0; i < 1000; ++i) {
+        Record record = {i, i * i};
+        records.push_back(record);
+    }
+    REQUIRE(write(fd, &records[0], records.size() * sizeof(Record)) ==
+            static_cast<ssize_t>(records.size() * sizeof(Record)));
+    // a partial record at the end is left out.
+    REQUIRE(write(fd, "abc", 3) == 3);
+    close(fd);
+
+    MappedArray<Record> array(path);
+    REQUIRE(array.is_open());
+    REQUIRE(array.advise(MappedArray<Record>::sequential));
+    REQUIRE(array.size() == 1000);
+    REQUIRE(array[999].value == 999 * 999);
+    REQUIRE(array.end() - array.begin() == 1000);
+
+    MmapIterator<Record> mit = iterator(array);
+    Iterator<const Record>* it = &mit;
+    size_t min, max;
+    REQUIRE(it->min_size(min));
+    REQUIRE(it->max_size(max));
+    REQUIRE(min == 1000);
+    REQUIRE(max == 1000);
+    REQUIRE(it->nth(10)->key == 10);
+    REQUIRE(it->count() == 990);
+
+    unlink(path);
+    MappedArray<Record> missing(path);
+    REQUIRE_FALSE(missing.is_open());
+    REQUIRE(missing.empty());
+}
+
+static std::vector<std::string> split_lines(const std::string& text) {
+    std::vector<std::string> lines;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+        lines.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+    return lines;
+}
+
+static std::string test_text() {
+    std::string text;
+    for (int i = 0; i < 300; ++i) {
+        text += std::string(i % 23, 'a' + i % 26);
+        text += '\n';
+    }
+    text += "no newline at the end";
+    return text;
+}
+
+TEST_CASE("LineIterator over memory") {
+    std::string text = test_text();
+    std::vector<std::string> expected = split_lines(text);
+    LineIterator lit(text.data(), text.data() + text.size());
+    Iterator<const StringView>* it = &lit;
+    std::vector<std::string> lines;
+    for (const StringView* line = it->get(); line; line = (++*it).get()) {
+        lines.push_back(line->str());
+    }
+    REQUIRE(lines == expected);
+
+    const char* empty = "";
+    REQUIRE(StaticLineIterator(empty, empty).get() == NULL);
+    const char* blank = "\n\n";
+    REQUIRE(StaticLineIterator(blank, blank + 2).count() == 2);
+}
+
+TEST_CASE("LineIterator over a file descriptor") {
+    std::string text = test_text();
+    std::vector<std::string> expected = split_lines(text);
+    char path[] = "/tmp/prelude-lines-XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    REQUIRE(write(fd, text.data(), text.size()) ==
+            static_cast<ssize_t>(text.size()));
+
+    // buffers smaller than a line have to grow.
+    for (size_t buffer_size = 1; buffer_size < 100; buffer_size += 7) {
+        REQUIRE(lseek(fd, 0, SEEK_SET) == 0);
+        StaticLineIterator lines(fd, '\n', buffer_size);
+        std::vector<std::string> actual;
+        size_t size;
+        // every view of a chunk must still be intact when it is read.
+        for (const StringView* chunk = lines.next_chunk(size); chunk;
+             chunk = lines.next_chunk(size)) {
+            for (size_t i = 0; i < size; ++i) {
+                actual.push_back(chunk[i].str());
+            }
+        }
+        REQUIRE(actual == expected);
+    }
+
+    REQUIRE(lseek(fd, 0, SEEK_SET) == 0);
+    StaticLineIterator lines(fd, '\n', 16);
+    ++lines;
+    StaticLineIterator copy = lines;
+    ++lines;
+    REQUIRE(copy.get()->str() == expected[1]);
+    REQUIRE((++copy).get()->str() == expected[2]);
+    close(fd);
+    unlink(path);
+}
+
+TEST_CASE("split") {
+    std::vector<int> vec(101, 1);
+    VectorIterator<int> vit = iterator(vec);
+    Iterator<int>* back = vit.split();
+    REQUIRE(back != NULL);
+    REQUIRE(vit.count() == 50);
+    REQUIRE(back->count() == 51);
+    REQUIRE(back->split() == NULL);
+    delete back;
+
+    const char* text = "one\ntwo\nthree\nfour\nfive\n";
+    LineIterator lines(text, text + strlen(text));
+    ++lines;
+    Iterator<const StringView>* rest = lines.split();
+    REQUIRE(rest != NULL);
+    REQUIRE(lines.get()->str() == "two");
+    // the split is at the first line past the middle of what is left.
+    REQUIRE(lines.count() == 3);
+    REQUIRE(rest->get()->str() == "five");
+    REQUIRE(rest->count() == 1);
+    delete rest;
+
+    int array[] = {1, 2, 3};
+    Strided odds(array, array + 3);
+    REQUIRE(odds.split() == NULL);
+}
+
+TEST_CASE("PrefetchingIterator") {
+    std::vector<int> vec;
+    for (int i = 1; i <= 10; ++i) {
+        vec.push_back(i);
+    }
+    VectorIterator<int> vit = iterator(vec);
+    PrefetchingIterator<int> pit = prefetching(vit, 4);
+    REQUIRE(pit.get() == &vec[0]);
+    ++pit;
+    REQUIRE(*pit == 2);
+    REQUIRE(pit.count() == 9);
+    REQUIRE(pit.get() == NULL);
+
+    // chunks are cut to the distance so the fetches stay ahead.
+    VectorIterator<int> vit2 = iterator(vec);
+    PrefetchingIterator<int> pit2 = prefetching(vit2, 3);
+    size_t chunks;
+    REQUIRE(sum_chunks(pit2, chunks) == 55);
+    REQUIRE(chunks == 4);
+
+    // one item chunks: the current item comes from the source between
+    // pulls.
+    VirtualIterator<StaticStrided> sit =
+        virtual_iterator(StaticStrided(&vec[0], &vec[0] + vec.size()));
+    PrefetchingIterator<int> pit3 = prefetching(sit, 8);
+    std::vector<int> seen;
+    for (; pit3.get(); ++pit3) {
+        seen.push_back(*pit3);
+    }
+    REQUIRE(seen.size() == 5);
+    REQUIRE(seen[4] == 9);
+}
+
+// jumps in `skip` and counts the single steps, so tests can tell
+// which one the other members use.
+struct CountingSteps : StaticIterator<CountingSteps, int> {
+    StaticVectorIterator<int> it;
+    size_t steps;
+    explicit CountingSteps(std::vector<int>& vec)
+        : it(static_iterator(vec)), steps(0) {}
+    CountingSteps& operator++() {
+        ++steps;
+        ++it;
+        return *this;
+    }
+    int* get() const { return it.get(); }
+    bool min_size(size_t& size) const { return it.min_size(size); }
+    size_t skip(size_t n) { return it.skip(n); }
+};
+
+TEST_CASE("skip") {
+    std::vector<int> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(i);
+    }
+    VectorIterator<int> vit = iterator(vec);
+    REQUIRE(vit.skip(10) == 10);
+    REQUIRE(*vit == 10);
+    REQUIRE(*vit.nth(5) == 15);
+    REQUIRE(*vit == 15);
+    REQUIRE(vit.nth(85) == NULL);
+    REQUIRE(vit.skip(1) == 0);
+
+    VectorIterator<int> vit2 = iterator(vec);
+    REQUIRE(vit2.skip(1000) == 100);
+    REQUIRE(vit2.get() == NULL);
+
+    // `last` jumps over what `min_size` knows is left.
+    CountingSteps steps(vec);
+    REQUIRE(*steps.nth(3) == 3);
+    REQUIRE(steps.steps == 0);
+    REQUIRE(*steps.last() == 99);
+    REQUIRE(steps.steps == 1);
+    REQUIRE(steps.get() == NULL);
+
+    VirtualIterator<CountingSteps> vsteps =
+        virtual_iterator(CountingSteps(vec));
+    REQUIRE(vsteps.skip(50) == 50);
+    REQUIRE(vsteps.count() == 50);
+    REQUIRE(vsteps.iter.steps == 0);
+
+    // the default `skip` steps.
+    int array[] = {1, 2, 3, 4, 5, 6, 7};
+    StaticStrided odds(array, array + 7);
+    REQUIRE(odds.skip(2) == 2);
+    REQUIRE(*odds == 5);
+    REQUIRE(odds.skip(5) == 2);
+
+    // skipping past the chunk a prefetching iterator holds.
+    VectorIterator<int> source = iterator(vec);
+    PrefetchingIterator<int> pit = prefetching(source, 4);
+    size_t size;
+    REQUIRE(*pit.next_chunk(size) == 0);
+    REQUIRE(pit.skip(90) == 90);
+    REQUIRE(*pit == 94);
+    REQUIRE(pit.skip(10) == 6);
+    REQUIRE(pit.get() == NULL);
+
+    const char* text = "a\nb\nc\n";
+    LineIterator lines(text, text + 6);
+    REQUIRE(lines.nth(2)->str() == "c");
+    REQUIRE(lines.skip(3) == 1);
+}
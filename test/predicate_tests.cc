@@ -74,3 +74,70 @@ TEST_CASE("not1") {
     REQUIRE(pred(3));
     REQUIRE(pred(4));
 }
+
+TEST_CASE("compile time bounds") {
+    ConstantPredicate<int, 3, less<int> > pred = is_less_than<3>();
+    REQUIRE(pred(2));
+    REQUIRE_FALSE(pred(3));
+    REQUIRE_FALSE(pred(4));
+
+    ConstantPredicate<char, 'm', greater_equal<char> > letters =
+        is_greater_than_or_equal_to<char, 'm'>();
+    REQUIRE(letters('m'));
+    REQUIRE(letters('z'));
+    REQUIRE_FALSE(letters('a'));
+
+    REQUIRE((is_greater_than<0>() and is_less_than<10>())(5));
+    REQUIRE_FALSE((is_greater_than<0>() and is_less_than<10>())(10));
+    REQUIRE((not is_equal_to<7>())(8));
+}
+
+template <class T>
+static void check_divisibility(T first, T last, T divisor) {
+    DivisibilityPredicate<T> pred = is_divisible_by(divisor);
+    for (T x = first;; ++x) {
+        if (divisor == 0) {
+            REQUIRE(pred(x) == (x == 0));
+        } else {
+            REQUIRE(pred(x) == (x % divisor == 0));
+        }
+        if (x == last) {
+            break;
+        }
+    }
+}
+
+TEST_CASE("is_divisible_by") {
+    // every pair of 8 bit values.
+    for (int d = -128; d < 128; ++d) {
+        check_divisibility<signed char>(-128, 127, d);
+    }
+    for (int d = 0; d < 256; ++d) {
+        check_divisibility<unsigned char>(0, 255, d);
+    }
+
+    int divisors[] = {1, 2, 3, 6, 7, 24, 1000, 65536, 2147483647};
+    for (size_t i = 0; i < sizeof(divisors) / sizeof(*divisors); ++i) {
+        int d = divisors[i];
+        check_divisibility<int>(-2000, 2000, d);
+        check_divisibility<int>(-2000, 2000, -d);
+        check_divisibility<int>(-2147483647 - 1, -2147483647 + 2000, d);
+        check_divisibility<int>(2147483647 - 2000, 2147483647, d);
+        check_divisibility<unsigned>(4294967295u - 2000, 4294967295u,
+                                     unsigned(d));
+        check_divisibility<long long>(-2000, 2000, d);
+        // around the largest multiple of `d` that leaves room for 1000
+        // more.
+        long long top = (9223372036854775807ll - 1000) / d * d;
+        check_divisibility<long long>(top - 1000, top + 1000, d);
+        check_divisibility<unsigned long long>(
+            18446744073709551615ull - 2000, 18446744073709551615ull,
+            static_cast<unsigned long long>(d));
+    }
+}
+
+TEST_CASE("is_divisible_by combines") {
+    REQUIRE((is_divisible_by(3) and is_divisible_by(5))(30));
+    REQUIRE_FALSE((is_divisible_by(3) and is_divisible_by(5))(9));
+    REQUIRE((not is_divisible_by(2))(9));
+}
@@ -0,0 +1,91 @@
+#include "catch.hpp"
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "../src/radix_sort.hh"
+
+using namespace prelude;
+
+template <class T>
+static std::vector<T> scrambled(size_t n, T scale, T offset) {
+    std::vector<T> vec;
+    uint64_t state = 88172645463325252ULL;
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        vec.push_back(static_cast<T>(state % 1000003) * scale + offset);
+    }
+    return vec;
+}
+
+template <class T>
+static void check_radix_sort(std::vector<T> vec) {
+    std::vector<T> expected = vec;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(vec);
+    REQUIRE(vec == expected);
+}
+
+TEST_CASE("radix_sort unsigned") {
+    check_radix_sort(scrambled<uint32_t>(5000, 4099, 0));
+    check_radix_sort(scrambled<uint64_t>(5000, 1ULL << 33, 7));
+    check_radix_sort(scrambled<uint8_t>(5000, 1, 0));
+}
+
+TEST_CASE("radix_sort signed") {
+    check_radix_sort(scrambled<int32_t>(5000, 3, -1500000));
+    check_radix_sort(scrambled<int64_t>(5000, -(1LL << 40), 3));
+    check_radix_sort(scrambled<int16_t>(5000, 1, -500));
+}
+
+TEST_CASE("radix_sort floating point") {
+    check_radix_sort(scrambled<double>(5000, -0.5, 1000.25));
+    check_radix_sort(scrambled<float>(5000, 0.125f, -300.0f));
+}
+
+TEST_CASE("radix_sort with constant byte columns") {
+    // only the lowest byte differs, every other pass is skipped
+    std::vector<uint64_t> vec = scrambled<uint64_t>(300, 1, 0);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = 0x1234567800000000ULL | (vec[i] & 0xff);
+    }
+    check_radix_sort(vec);
+
+    std::vector<int> same(100, -5);
+    check_radix_sort(same);
+    check_radix_sort(std::vector<int>());
+}
+
+struct Record {
+    int key;
+    int order;
+};
+
+struct RecordKey {
+    int operator()(const Record& record) const { return record.key; }
+};
+
+TEST_CASE("radix_sort_by is stable") {
+    std::vector<Record> records;
+    for (int i = 0; i < 1000; ++i) {
+        Record record = {(i * 37) % 11 - 5, i};
+        records.push_back(record);
+    }
+    radix_sort_by(records, RecordKey());
+    for (size_t i = 1; i < records.size(); ++i) {
+        REQUIRE(records[i - 1].key <= records[i].key);
+        if (records[i - 1].key == records[i].key) {
+            REQUIRE(records[i - 1].order < records[i].order);
+        }
+    }
+}
+
+TEST_CASE("radix::sort picks radix sort for arithmetic types") {
+    std::vector<uint32_t> vec = scrambled<uint32_t>(3000, 77, 1);
+    std::vector<uint32_t> expected = vec;
+    std::sort(expected.begin(), expected.end());
+    radix::sort(vec.begin(), vec.end());
+    REQUIRE(vec == expected);
+}
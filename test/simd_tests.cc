@@ -0,0 +1,278 @@
+#include "catch.hpp"
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include "../src/predicate.hh"
+#include "../src/simd.hh"
+
+using namespace prelude;
+
+template <class T>
+static void check_find_count() {
+    // cover the vector body and the scalar tail of every width.
+    for (size_t n = 0; n < 70; ++n) {
+        std::vector<T> vec(n, T(1));
+        REQUIRE(simd::find(vec.begin(), vec.end(), T(2)) == vec.end());
+        REQUIRE(simd::count(vec.begin(), vec.end(), T(2)) == 0);
+        REQUIRE(simd::count(vec.begin(), vec.end(), T(1)) ==
+                static_cast<ptrdiff_t>(n));
+        for (size_t i = 0; i < n; ++i) {
+            vec[i] = T(2);
+            REQUIRE(simd::find(vec.begin(), vec.end(), T(2)) ==
+                    vec.begin() + i);
+            REQUIRE(simd::count(vec.begin(), vec.end(), T(2)) == 1);
+            vec[i] = T(1);
+        }
+    }
+}
+
+TEST_CASE("simd::find and simd::count") {
+    check_find_count<uint8_t>();
+    check_find_count<int8_t>();
+    check_find_count<int16_t>();
+    check_find_count<int32_t>();
+    check_find_count<uint32_t>();
+    check_find_count<int64_t>();
+    check_find_count<float>();
+    check_find_count<double>();
+}
+
+TEST_CASE("simd::find only matches whole 64 bit lanes") {
+    std::vector<int64_t> vec(8, 0);
+    vec[3] = 0x100000000LL;
+    vec[5] = 1;
+    REQUIRE(simd::find(vec.begin(), vec.end(), int64_t(1)) ==
+            vec.begin() + 5);
+    REQUIRE(simd::count(vec.begin(), vec.end(), int64_t(1)) == 1);
+}
+
+TEST_CASE("simd::find on floating point follows operator==") {
+    std::vector<double> vec(9, 1.0);
+    vec[4] = -0.0;
+    REQUIRE(simd::find(vec.begin(), vec.end(), 0.0) == vec.begin() + 4);
+}
+
+TEST_CASE("simd::count_if") {
+    std::vector<int> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(i);
+    }
+    REQUIRE(simd::count_if(vec.begin(), vec.end(), is_odd<int>()) == 50);
+    REQUIRE(simd::count_if(&vec[0] + 10, &vec[0] + 20,
+                           is_even<int>()) == 5);
+}
+
+template <simd::comparison Op, class T>
+static void check_compare_mask(const std::vector<T>& vec, T operand) {
+    for (size_t i = 0; i + 64 <= vec.size(); i += 64) {
+        uint64_t expected = 0;
+        for (size_t j = 0; j < 64; ++j) {
+            expected |= uint64_t(simd::holds<Op>(vec[i + j], operand)) << j;
+        }
+        REQUIRE(simd::compare_mask<Op>(&vec[i], 64, operand) == expected);
+    }
+}
+
+template <class T>
+static void check_compare_masks() {
+    const T high = std::numeric_limits<T>::max();
+    const T low = std::numeric_limits<T>::is_integer
+                      ? std::numeric_limits<T>::min()
+                      : -high;
+    std::vector<T> vec;
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < 256; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        vec.push_back(state % 3 == 0 ? low : state % 3 == 1 ? high
+                                                           : T(state));
+    }
+    // the extremes catch unsigned lanes compared as signed.
+    T operands[] = {low, high, T(0), T(7), T(state)};
+    for (size_t i = 0; i < sizeof(operands) / sizeof(*operands); ++i) {
+        check_compare_mask<simd::cmp_eq>(vec, operands[i]);
+        check_compare_mask<simd::cmp_ne>(vec, operands[i]);
+        check_compare_mask<simd::cmp_lt>(vec, operands[i]);
+        check_compare_mask<simd::cmp_gt>(vec, operands[i]);
+        check_compare_mask<simd::cmp_le>(vec, operands[i]);
+        check_compare_mask<simd::cmp_ge>(vec, operands[i]);
+    }
+}
+
+TEST_CASE("simd::compare_mask matches the scalar comparisons") {
+    check_compare_masks<int8_t>();
+    check_compare_masks<uint8_t>();
+    check_compare_masks<int16_t>();
+    check_compare_masks<uint16_t>();
+    check_compare_masks<int32_t>();
+    check_compare_masks<uint32_t>();
+    check_compare_masks<int64_t>();
+    check_compare_masks<uint64_t>();
+    check_compare_masks<float>();
+    check_compare_masks<double>();
+}
+
+TEST_CASE("simd::compare_mask on NaN follows the operators") {
+    std::vector<double> vec(64, 1.0);
+    vec[3] = std::numeric_limits<double>::quiet_NaN();
+    check_compare_mask<simd::cmp_ne>(vec, 1.0);
+    check_compare_mask<simd::cmp_le>(vec, 1.0);
+    check_compare_mask<simd::cmp_ge>(vec, 1.0);
+    REQUIRE(simd::compare_mask<simd::cmp_ge>(&vec[0], 64, 1.0) ==
+            ~(uint64_t(1) << 3));
+}
+
+// sorted, and strictly increasing unless `min_step` is 0.
+// `Word` is the unsigned type of `T`'s size, so the most negative
+// value and -1 don't overflow `%`.
+template <class T, class Word>
+static bool divides(T divisor, T x) {
+    Word d = divisor < T(0) ? Word(0) - Word(divisor) : Word(divisor);
+    Word m = x < T(0) ? Word(0) - Word(x) : Word(x);
+    return d == 0 ? m == 0 : m % d == 0;
+}
+
+template <class T, class Word>
+static void check_divisible_mask() {
+    const T min = std::numeric_limits<T>::min();
+    const T max = std::numeric_limits<T>::max();
+    std::vector<T> vec;
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < 64; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        vec.push_back(i % 2 ? T(i * 12) - T(300) : T(state));
+    }
+    vec[0] = min;
+    vec[1] = max;
+    vec[2] = T(0);
+    vec[3] = T(min + T(1));
+    const T divisors[] = {T(0), T(1),   T(2),    T(3),  T(6),
+                          T(7), T(8),   T(12),   T(64), T(1000),
+                          max,  min,    T(-1),   T(-6), T(max / 3)};
+    for (size_t d = 0; d < sizeof(divisors) / sizeof(*divisors); ++d) {
+        DivisibilityPredicate<T> pred(divisors[d]);
+        uint64_t expected = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            expected |= uint64_t(divides<T, Word>(divisors[d], vec[i]))
+                        << i;
+        }
+        REQUIRE(simd::divisible_mask(&vec[0], 64, pred) == expected);
+        REQUIRE(simd::divisible_mask(&vec[0], 37, pred) ==
+                (expected & ((uint64_t(1) << 37) - 1)));
+    }
+}
+
+TEST_CASE("simd::divisible_mask matches %") {
+    check_divisible_mask<int32_t, uint32_t>();
+    check_divisible_mask<uint32_t, uint32_t>();
+    check_divisible_mask<int64_t, uint64_t>();
+    check_divisible_mask<uint64_t, uint64_t>();
+    check_divisible_mask<int16_t, uint16_t>();
+}
+
+template <class T>
+static std::vector<T> sparse_set(size_t n, uint32_t seed, T first,
+                                 uint32_t min_step, uint32_t spread) {
+    std::vector<T> vec;
+    T value = first;
+    uint32_t state = seed * 2654435761u + 1;
+    for (size_t i = 0; i < n; ++i) {
+        state = state * 1103515245u + 12345u;
+        value += static_cast<T>(min_step + (state >> 16) % spread);
+        vec.push_back(value);
+    }
+    return vec;
+}
+
+template <class T>
+static void check_set_operations(T first, uint32_t min_step) {
+    for (size_t na = 0; na < 40; na += 3) {
+        for (size_t nb = 0; nb < 40; nb += 5) {
+            for (uint32_t spread = 1; spread < 5; ++spread) {
+                std::vector<T> a =
+                    sparse_set(na, 1, first, min_step, spread);
+                std::vector<T> b =
+                    sparse_set(nb, 2, first, min_step, spread);
+                std::vector<T> expected, actual;
+                std::set_intersection(a.begin(), a.end(), b.begin(),
+                                      b.end(),
+                                      std::back_inserter(expected));
+                simd::set_intersection(a.begin(), a.end(), b.begin(),
+                                       b.end(),
+                                       std::back_inserter(actual));
+                REQUIRE(actual == expected);
+
+                expected.clear();
+                actual.clear();
+                std::set_difference(a.begin(), a.end(), b.begin(),
+                                    b.end(), std::back_inserter(expected));
+                simd::set_difference(a.begin(), a.end(), b.begin(),
+                                     b.end(), std::back_inserter(actual));
+                REQUIRE(actual == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("simd::set_intersection and simd::set_difference") {
+    check_set_operations<int32_t>(-1000, 1);
+    // across the sign bit, which unsigned lanes must ignore.
+    check_set_operations<uint32_t>(2147483647u - 40, 1);
+}
+
+TEST_CASE("simd set operations keep duplicates") {
+    check_set_operations<int32_t>(-1000, 0);
+    check_set_operations<uint32_t>(2147483647u - 40, 0);
+}
+
+template <class T>
+static void check_find_zero() {
+    // every start and terminator position around two vectors.
+    T buffer[80];
+    for (size_t start = 0; start < 16; ++start) {
+        for (size_t end = start; end < 80; ++end) {
+            for (size_t i = 0; i < 80; ++i) {
+                buffer[i] = T(1);
+            }
+            buffer[end] = T(0);
+            REQUIRE(simd::find_zero(buffer + start) == buffer + end);
+        }
+    }
+}
+
+TEST_CASE("simd::find_zero") {
+    check_find_zero<char>();
+    check_find_zero<uint16_t>();
+    check_find_zero<wchar_t>();
+    check_find_zero<uint64_t>();
+}
+
+TEST_CASE("simd::find_zero stays inside the page") {
+    // the terminator is the last thing before an unreadable page.
+    long page = sysconf(_SC_PAGESIZE);
+    char* map = static_cast<char*>(
+        mmap(NULL, 2 * page, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    REQUIRE(map != MAP_FAILED);
+    REQUIRE(mprotect(map + page, page, PROT_NONE) == 0);
+    memset(map, 'x', page);
+    map[page - 1] = 0;
+    for (long start = page - 70; start < page; ++start) {
+        REQUIRE(simd::find_zero(map + start) == map + page - 1);
+    }
+    const char** pointers = reinterpret_cast<const char**>(map + page) - 3;
+    pointers[0] = "a";
+    pointers[1] = "b";
+    pointers[2] = NULL;
+    REQUIRE(simd::find_zero(pointers) == pointers + 2);
+    munmap(map, 2 * page);
+}
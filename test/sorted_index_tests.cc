@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "../src/algorithm.hh"
+#include "../src/sorted_index.hh"
+
+using namespace prelude;
+
+TEST_CASE("SortedIndex agrees with std::lower_bound") {
+    // every tree shape from empty up to a few full levels
+    for (int n = 0; n < 70; ++n) {
+        std::vector<int> vec;
+        for (int i = 0; i < n; ++i) {
+            vec.push_back(2 * (i / 3));
+        }
+        SortedIndex<int> index = sorted_index(vec);
+        REQUIRE(index.size() == vec.size());
+        for (int val = -1; val <= 2 * n / 3 + 2; ++val) {
+            size_t lower =
+                std::lower_bound(vec.begin(), vec.end(), val) - vec.begin();
+            size_t upper =
+                std::upper_bound(vec.begin(), vec.end(), val) - vec.begin();
+            REQUIRE(lower_bound(index, val) == lower);
+            REQUIRE(upper_bound(index, val) == upper);
+            REQUIRE(equal_range(index, val) ==
+                    std::make_pair(lower, upper));
+            REQUIRE(binary_search(index, val) ==
+                    std::binary_search(vec.begin(), vec.end(), val));
+        }
+    }
+}
+
+TEST_CASE("SortedIndex with a comparator") {
+    std::vector<double> vec;
+    vec.push_back(9.5);
+    vec.push_back(4.0);
+    vec.push_back(4.0);
+    vec.push_back(-1.0);
+    SortedIndex<double, std::greater<double> > index =
+        sorted_index_with(vec, std::greater<double>());
+    REQUIRE(index.lower_bound(4.0) == 1);
+    REQUIRE(index.upper_bound(4.0) == 3);
+    REQUIRE(index.lower_bound(100.0) == 0);
+    REQUIRE(index.lower_bound(-5.0) == 4);
+    REQUIRE(index.binary_search(9.5));
+    REQUIRE_FALSE(index.binary_search(5.0));
+}
+
+TEST_CASE("SortedIndex lookups beside the container algorithms") {
+    std::vector<int> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i * 2);
+    }
+    SortedIndex<int> index = sorted_index(vec);
+    const SortedIndex<int>& const_index = index;
+    REQUIRE(lower_bound(index, 10) == 5);
+    REQUIRE(lower_bound(const_index, 10) == 5);
+    REQUIRE(upper_bound(index, 10) == 6);
+    REQUIRE(equal_range(index, 10) == std::make_pair(size_t(5), size_t(6)));
+    REQUIRE(binary_search(index, 10));
+    // containers still get iterators.
+    REQUIRE(lower_bound(vec, 10) == vec.begin() + 5);
+}
@@ -0,0 +1,77 @@
+#include "catch.hpp"
+
+#include <list>
+#include <vector>
+#include "../src/algorithm.hh"
+#include "../src/view.hh"
+
+using namespace prelude;
+
+struct IsOdd {
+    bool operator()(int i) const { return i % 2 != 0; }
+};
+
+struct Square {
+    typedef int result_type;
+    int operator()(int i) const { return i * i; }
+};
+
+// counts calls so the tests can see how much work a view did.
+struct CountingSquare {
+    typedef int result_type;
+    int* calls;
+    int operator()(int i) const {
+        ++*calls;
+        return i * i;
+    }
+};
+
+TEST_CASE("view::filter and view::transform") {
+    std::vector<int> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i);
+    }
+    std::vector<int> squares =
+        materialize<std::vector<int> >(
+            view::transform(view::filter(vec, IsOdd()), Square()));
+    REQUIRE(squares.size() == 5);
+    REQUIRE(squares[0] == 1);
+    REQUIRE(squares[4] == 81);
+}
+
+TEST_CASE("view::take stops evaluating early") {
+    std::vector<int> vec(1000, 3);
+    int calls = 0;
+    CountingSquare square = {&calls};
+    std::vector<int> output(1, 7);
+    materialize(view::take(view::transform(vec, square), 4), output);
+    REQUIRE(output.size() == 5);
+    REQUIRE(output[0] == 7);
+    REQUIRE(output[4] == 9);
+    REQUIRE(calls == 4);
+
+    REQUIRE(materialize<std::vector<int> >(view::take(vec, 0)).empty());
+    REQUIRE(materialize<std::vector<int> >(view::take(vec, 5000)).size() ==
+            1000);
+}
+
+TEST_CASE("view::unique") {
+    int array[] = {1, 1, 2, 3, 3, 3, 1, 4, 4};
+    std::list<int> list(array, array + 9);
+    std::vector<int> unique =
+        materialize<std::vector<int> >(view::unique(list));
+    int expected[] = {1, 2, 3, 1, 4};
+    REQUIRE(unique == std::vector<int>(expected, expected + 5));
+
+    REQUIRE(materialize<std::vector<int> >(
+                view::unique(view::range(array, array))).empty());
+}
+
+TEST_CASE("algorithms run over views") {
+    std::vector<int> vec;
+    for (int i = 0; i < 100; ++i) {
+        vec.push_back(i / 3);
+    }
+    REQUIRE(count_if(view::unique(vec), IsOdd()) == 17);
+    REQUIRE(*find(view::transform(vec, Square()), 4) == 4);
+}
@@ -0,0 +1,156 @@
+#include "catch.hpp"
+
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../src/algorithm.hh"
+#include "../src/zip.hh"
+
+using namespace prelude;
+
+static std::vector<int> scrambled_keys(size_t n) {
+    std::vector<int> keys;
+    uint32_t state = 2463534242u;
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        keys.push_back(static_cast<int>(state % 97));
+    }
+    return keys;
+}
+
+// the payload of each key is the position it started at.
+static std::vector<size_t> positions(size_t n) {
+    std::vector<size_t> payload;
+    for (size_t i = 0; i < n; ++i) {
+        payload.push_back(i);
+    }
+    return payload;
+}
+
+static void check_permuted(const std::vector<int>& original,
+                           const std::vector<int>& keys,
+                           const std::vector<size_t>& payload) {
+    REQUIRE(keys.size() == payload.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE(keys[i] == original[payload[i]]);
+    }
+}
+
+static bool ascending(const std::vector<int>& keys) {
+    return std::adjacent_find(keys.begin(), keys.end(),
+                              std::greater<int>()) == keys.end();
+}
+
+// in place: the zip points into the columns.
+static void reset(const std::vector<int>& original, std::vector<int>& keys,
+                  std::vector<size_t>& payload) {
+    std::copy(original.begin(), original.end(), keys.begin());
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = i;
+    }
+}
+
+struct IsEven {
+    template <class Element>
+    bool operator()(const Element& element) const {
+        return element.first % 2 == 0;
+    }
+};
+
+TEST_CASE("sort and stable_sort a zip") {
+    const std::vector<int> original = scrambled_keys(2000);
+    std::vector<int> keys = original;
+    std::vector<size_t> payload = positions(keys.size());
+    view::Range<ZipIterator<std::vector<int>::iterator,
+                            std::vector<size_t>::iterator> >
+        zipped = zip(keys, payload);
+    prelude::sort(zipped.begin(), zipped.end());
+    REQUIRE(ascending(keys));
+    check_permuted(original, keys, payload);
+
+    reset(original, keys, payload);
+    prelude::stable_sort(zipped.begin(), zipped.end());
+    REQUIRE(ascending(keys));
+    check_permuted(original, keys, payload);
+    for (size_t i = 1; i < keys.size(); ++i) {
+        if (keys[i - 1] == keys[i]) {
+            REQUIRE(payload[i - 1] < payload[i]);
+        }
+    }
+
+    reset(original, keys, payload);
+    prelude::sort_with(zipped.begin(), zipped.end(),
+                       zip_compare(std::greater<int>()));
+    REQUIRE(std::adjacent_find(keys.begin(), keys.end(),
+                               std::less<int>()) == keys.end());
+    check_permuted(original, keys, payload);
+}
+
+TEST_CASE("partition, nth_element and rotate a zip") {
+    const std::vector<int> original = scrambled_keys(500);
+    std::vector<int> keys = original;
+    std::vector<size_t> payload = positions(keys.size());
+    view::Range<ZipIterator<std::vector<int>::iterator,
+                            std::vector<size_t>::iterator> >
+        zipped = zip(keys, payload);
+
+    ZipIterator<std::vector<int>::iterator, std::vector<size_t>::iterator>
+        middle = prelude::partition(zipped.begin(), zipped.end(), IsEven());
+    size_t evens = middle - zipped.begin();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        REQUIRE((keys[i] % 2 == 0) == (i < evens));
+    }
+    check_permuted(original, keys, payload);
+
+    ZipIterator<std::vector<int>::iterator, std::vector<size_t>::iterator>
+        nth = zipped.begin() + 250;
+    prelude::nth_element(zipped.begin(), nth, zipped.end());
+    std::vector<int> sorted = original;
+    std::sort(sorted.begin(), sorted.end());
+    REQUIRE(keys[250] == sorted[250]);
+    check_permuted(original, keys, payload);
+
+    std::vector<int> before = keys;
+    prelude::rotate(zipped.begin(), zipped.begin() + 7, zipped.end());
+    REQUIRE(keys[0] == before[7]);
+    REQUIRE(keys[keys.size() - 7] == before[0]);
+    check_permuted(original, keys, payload);
+}
+
+TEST_CASE("zips of zips carry more columns") {
+    std::vector<int> keys;
+    std::vector<std::string> names;
+    std::vector<double> weights;
+    for (int i = 0; i < 100; ++i) {
+        keys.push_back((i * 37) % 100);
+        names.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+        weights.push_back(i * 0.5);
+    }
+    std::vector<int> original = keys;
+    std::vector<std::string> original_names = names;
+
+    view::Range<ZipIterator<
+        std::vector<int>::iterator,
+        ZipIterator<std::vector<std::string>::iterator,
+                    std::vector<double>::iterator> > >
+        zipped = zip(keys, zip(names, weights));
+    prelude::stable_sort(zipped.begin(), zipped.end());
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(keys[i] == i);
+        // the element that had key `i` started at `weight * 2`.
+        size_t from = static_cast<size_t>(weights[i] * 2);
+        REQUIRE(original[from] == i);
+        REQUIRE(names[i] == original_names[from]);
+    }
+
+    ZipValue<int, ZipValue<std::string, double> > first = *zipped.begin();
+    REQUIRE(first.first == 0);
+    REQUIRE(first.second.first == names[0]);
+    *zipped.begin() = *(zipped.begin() + 1);
+    REQUIRE(keys[0] == 1);
+    REQUIRE(names[0] == names[1]);
+}